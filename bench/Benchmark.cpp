@@ -0,0 +1,579 @@
+//============================================================================
+// Name        : Benchmark.cpp
+// Description : ArrayList against std::vector, LinkedList against std::list and std::forward_list
+//
+// Build: g++ -std=c++20 -O2 bench/Benchmark.cpp -o Benchmark
+// Run:   ./Benchmark [--max-size N] [--budget N] > results.json
+//
+// Times push_back, push_front, middle insert, middle erase, find, iteration, copy and move for int, std::string (too
+// long for the small string buffer) and a 64 byte POD, on containers of 10, 100, ... up to --max-size elements
+// (default 10^6, at most 10^8). Results go to stdout as JSON, one record per container, type, operation and size with
+// the average nanoseconds per operation. Progress goes to stderr.
+//
+// Operations that are O(n) each (middle insert/erase everywhere, push_front on the arrays, find) are only repeated
+// about budget / n times (default budget 10^8 element steps) so the big sizes don't run for hours. Every record says
+// how many operations it averaged over.
+//============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <forward_list>
+#include <iterator>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/ArrayList.hpp"
+#include "../include/LinkedList.hpp"
+
+namespace
+{
+	struct Pod64
+	{
+		std::uint64_t words[8];
+
+		bool operator==(const Pod64&) const = default;
+	};
+
+	static_assert(sizeof(Pod64) == 64);
+
+	// Values: pool[i] for the elements, missing() for a value that is never in a container
+
+	template<typename T>
+	T makeValue(std::size_t i);
+
+	template<>
+	int makeValue<int>(std::size_t i)
+	{
+		return static_cast<int>(i);
+	}
+
+	template<>
+	std::string makeValue<std::string>(std::size_t i)
+	{
+		// 24 characters, past any small string buffer
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "element-%016zu", i);
+		return buffer;
+	}
+
+	template<>
+	Pod64 makeValue<Pod64>(std::size_t i)
+	{
+		Pod64 value;
+		std::fill(std::begin(value.words), std::end(value.words), static_cast<std::uint64_t>(i));
+		return value;
+	}
+
+	template<typename T>
+	T missing()
+	{
+		if constexpr(std::is_same_v<T, int>)
+		{
+			return -1;
+		}
+		else if constexpr(std::is_same_v<T, std::string>)
+		{
+			return "missing";
+		}
+		else
+		{
+			return makeValue<T>(~std::size_t(0));
+		}
+	}
+
+	// A few distinct values cycled through, so string copies measure the container and not the formatting
+	template<typename T>
+	const std::vector<T>& pool()
+	{
+		static const std::vector<T> values = []
+		{
+			std::vector<T> generated;
+			for(std::size_t i = 0; i < 1024; ++i)
+			{
+				generated.push_back(makeValue<T>(i));
+			}
+
+			return generated;
+		}();
+
+		return values;
+	}
+
+	template<typename T>
+	const T& valueAt(std::size_t i)
+	{
+		return pool<T>()[i % 1024];
+	}
+
+	template<typename T>
+	const char* typeName()
+	{
+		if constexpr(std::is_same_v<T, int>)
+		{
+			return "int";
+		}
+		else if constexpr(std::is_same_v<T, std::string>)
+		{
+			return "std::string";
+		}
+		else
+		{
+			return "pod64";
+		}
+	}
+
+	// Keep the compiler from throwing away results it can see are unused
+	template<typename V>
+	void keep(const V& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	// Contribution of one element to the iteration checksum
+	template<typename T>
+	std::uint64_t weight(const T& value)
+	{
+		if constexpr(std::is_same_v<T, int>)
+		{
+			return static_cast<std::uint64_t>(value);
+		}
+		else if constexpr(std::is_same_v<T, std::string>)
+		{
+			return value.size();
+		}
+		else
+		{
+			return value.words[0];
+		}
+	}
+
+	/**
+	 * One adapter per container so the benchmarks can be written once. Positions are indexes, the std lists walk to
+	 * them with std::next() which is exactly what LinkedList does internally.
+	 */
+
+	template<typename T>
+	struct VectorAdapter
+	{
+		using Container = std::vector<T>;
+		static constexpr const char* NAME = "std::vector";
+		static constexpr bool CONSTANT_PUSH_FRONT = false;
+
+		static void pushBack(Container& container, const T& val)
+		{
+			container.push_back(val);
+		}
+
+		static void pushFront(Container& container, const T& val)
+		{
+			container.insert(container.begin(), val);
+		}
+
+		static void insertAt(Container& container, std::size_t index, const T& val)
+		{
+			container.insert(container.begin() + static_cast<std::ptrdiff_t>(index), val);
+		}
+
+		static void eraseAt(Container& container, std::size_t index)
+		{
+			container.erase(container.begin() + static_cast<std::ptrdiff_t>(index));
+		}
+
+		static bool contains(const Container& container, const T& val)
+		{
+			return std::find(container.begin(), container.end(), val) != container.end();
+		}
+	};
+
+	template<typename T>
+	struct ArrayListAdapter
+	{
+		using Container = ArrayList<T>;
+		static constexpr const char* NAME = "ArrayList";
+		static constexpr bool CONSTANT_PUSH_FRONT = false;
+
+		static void pushBack(Container& container, const T& val)
+		{
+			container.push_back(val);
+		}
+
+		static void pushFront(Container& container, const T& val)
+		{
+			container.push_front(val);
+		}
+
+		static void insertAt(Container& container, std::size_t index, const T& val)
+		{
+			container.insert(val, index);
+		}
+
+		static void eraseAt(Container& container, std::size_t index)
+		{
+			container.erase(index);
+		}
+
+		static bool contains(const Container& container, const T& val)
+		{
+			return container.contains(val);
+		}
+	};
+
+	template<typename T>
+	struct ListAdapter
+	{
+		using Container = std::list<T>;
+		static constexpr const char* NAME = "std::list";
+		static constexpr bool CONSTANT_PUSH_FRONT = true;
+
+		static void pushBack(Container& container, const T& val)
+		{
+			container.push_back(val);
+		}
+
+		static void pushFront(Container& container, const T& val)
+		{
+			container.push_front(val);
+		}
+
+		static void insertAt(Container& container, std::size_t index, const T& val)
+		{
+			container.insert(std::next(container.begin(), static_cast<std::ptrdiff_t>(index)), val);
+		}
+
+		static void eraseAt(Container& container, std::size_t index)
+		{
+			container.erase(std::next(container.begin(), static_cast<std::ptrdiff_t>(index)));
+		}
+
+		static bool contains(const Container& container, const T& val)
+		{
+			return std::find(container.begin(), container.end(), val) != container.end();
+		}
+	};
+
+	// No size() and no tail, push_back is insert_after on a tail iterator the benchmark keeps
+	template<typename T>
+	struct ForwardListAdapter
+	{
+		using Container = std::forward_list<T>;
+		static constexpr const char* NAME = "std::forward_list";
+		static constexpr bool CONSTANT_PUSH_FRONT = true;
+
+		static void pushFront(Container& container, const T& val)
+		{
+			container.push_front(val);
+		}
+
+		static void insertAt(Container& container, std::size_t index, const T& val)
+		{
+			container.insert_after(std::next(container.before_begin(), static_cast<std::ptrdiff_t>(index)), val);
+		}
+
+		static void eraseAt(Container& container, std::size_t index)
+		{
+			container.erase_after(std::next(container.before_begin(), static_cast<std::ptrdiff_t>(index)));
+		}
+
+		static bool contains(const Container& container, const T& val)
+		{
+			return std::find(container.begin(), container.end(), val) != container.end();
+		}
+	};
+
+	template<typename T>
+	struct LinkedListAdapter
+	{
+		using Container = LinkedList<T>;
+		static constexpr const char* NAME = "LinkedList";
+		static constexpr bool CONSTANT_PUSH_FRONT = true;
+
+		static void pushBack(Container& container, const T& val)
+		{
+			container.push_back(val);
+		}
+
+		static void pushFront(Container& container, const T& val)
+		{
+			container.push_front(val);
+		}
+
+		static void insertAt(Container& container, std::size_t index, const T& val)
+		{
+			container.insert(val, index);
+		}
+
+		static void eraseAt(Container& container, std::size_t index)
+		{
+			container.erase(index);
+		}
+
+		static bool contains(const Container& container, const T& val)
+		{
+			return container.contains(val);
+		}
+	};
+
+	struct Settings
+	{
+		std::size_t maxSize = 1000000;
+		std::size_t budget = 100000000;
+	};
+
+	class Report
+	{
+		public:
+			Report()
+			{
+				std::printf("{\n  \"benchmark\": \"containers\",\n  \"results\": [");
+			}
+
+			~Report()
+			{
+				std::printf("\n  ]\n}\n");
+			}
+
+			void add(const char* container, const char* type, const char* operation, std::size_t size,
+			         std::size_t ops, double nanoseconds)
+			{
+				std::printf("%s\n    {\"container\": \"%s\", \"type\": \"%s\", \"operation\": \"%s\", \"size\": %zu, "
+				            "\"ops\": %zu, \"ns_per_op\": %.3f}",
+				            mFirst ? "" : ",", container, type, operation, size, ops,
+				            nanoseconds / static_cast<double>(ops));
+				std::fflush(stdout);
+				mFirst = false;
+			}
+
+		private:
+			bool mFirst = true;
+	};
+
+	template<typename Function>
+	double timeNanoseconds(Function&& function)
+	{
+		auto start = std::chrono::steady_clock::now();
+		function();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// How often to repeat an operation that costs about cost element steps on a container of n elements
+	std::size_t repeats(const Settings& settings, std::size_t cost, std::size_t limit)
+	{
+		return std::clamp<std::size_t>(settings.budget / std::max<std::size_t>(cost, 1), 1, limit);
+	}
+
+	template<typename Adapter, typename T>
+	typename Adapter::Container build(std::size_t n)
+	{
+		typename Adapter::Container container;
+		if constexpr(std::is_same_v<Adapter, ForwardListAdapter<T>>)
+		{
+			auto tail = container.before_begin();
+			for(std::size_t i = 0; i < n; ++i)
+			{
+				tail = container.insert_after(tail, valueAt<T>(i));
+			}
+		}
+		else
+		{
+			for(std::size_t i = 0; i < n; ++i)
+			{
+				Adapter::pushBack(container, valueAt<T>(i));
+			}
+		}
+
+		return container;
+	}
+
+	template<typename Adapter, typename T>
+	void run(const Settings& settings, Report& report, std::size_t n)
+	{
+		using Container = typename Adapter::Container;
+		const char* type = typeName<T>();
+		auto record = [&](const char* operation, std::size_t ops, double nanoseconds)
+		{
+			report.add(Adapter::NAME, type, operation, n, ops, nanoseconds);
+		};
+
+		std::fprintf(stderr, "%s<%s> n=%zu\n", Adapter::NAME, type, n);
+
+		// push_back: build from empty, includes every reallocation or node allocation on the way
+		{
+			Container container;
+			double ns = timeNanoseconds([&] { container = build<Adapter, T>(n); });
+			keep(container);
+			record("push_back", n, ns);
+		}
+
+		Container container = build<Adapter, T>(n);
+
+		// push_front: grow from n, O(n) each on the arrays so those only do a budgeted number
+		{
+			std::size_t ops = Adapter::CONSTANT_PUSH_FRONT ? n : std::min(n, repeats(settings, n, n));
+			Container copy = container;
+			double ns = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; ++i)
+				{
+					Adapter::pushFront(copy, valueAt<T>(i));
+				}
+			});
+			keep(copy);
+			record("push_front", ops, ns);
+		}
+
+		// Middle insert then middle erase, the container stays around n elements
+		{
+			std::size_t ops = std::min(n, repeats(settings, n, 10000));
+			Container copy = container;
+			std::size_t size = n;
+
+			double insertNs = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; ++i)
+				{
+					Adapter::insertAt(copy, size / 2, valueAt<T>(i));
+					size++;
+				}
+			});
+			record("insert_middle", ops, insertNs);
+
+			double eraseNs = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; ++i)
+				{
+					Adapter::eraseAt(copy, size / 2);
+					size--;
+				}
+			});
+			keep(copy);
+			record("erase_middle", ops, eraseNs);
+		}
+
+		// find: value that isn't there, always a full scan
+		{
+			std::size_t ops = repeats(settings, n, 1000);
+			const T absent = missing<T>();
+			std::size_t found = 0;
+			double ns = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; ++i)
+				{
+					found += Adapter::contains(container, absent) ? 1 : 0;
+					keep(found);
+				}
+			});
+			record("find", ops, ns);
+		}
+
+		// Iteration: per element, over enough passes to get above timer resolution
+		{
+			std::size_t passes = repeats(settings, n, 1000);
+			std::uint64_t sum = 0;
+			double ns = timeNanoseconds([&]
+			{
+				for(std::size_t pass = 0; pass < passes; ++pass)
+				{
+					for(const T& value : container)
+					{
+						sum += weight(value);
+					}
+
+					keep(sum);
+				}
+			});
+			record("iterate", passes * std::max<std::size_t>(n, 1), ns);
+		}
+
+		// Copy: whole container per op
+		{
+			std::size_t ops = repeats(settings, n * 10, 1000);
+			double ns = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; ++i)
+				{
+					Container copy = container;
+					keep(copy);
+				}
+			});
+			record("copy", ops, ns);
+		}
+
+		// Move: construct out and assign back, should be O(1) for every container
+		{
+			const std::size_t ops = 10000;
+			double ns = timeNanoseconds([&]
+			{
+				for(std::size_t i = 0; i < ops; i += 2)
+				{
+					Container moved = std::move(container);
+					keep(moved);
+					container = std::move(moved);
+				}
+			});
+			keep(container);
+			record("move", ops, ns);
+		}
+	}
+
+	template<typename T>
+	void runType(const Settings& settings, Report& report)
+	{
+		for(std::size_t n = 10; n <= settings.maxSize; n *= 10)
+		{
+			run<ArrayListAdapter<T>, T>(settings, report, n);
+			run<VectorAdapter<T>, T>(settings, report, n);
+			run<LinkedListAdapter<T>, T>(settings, report, n);
+			run<ListAdapter<T>, T>(settings, report, n);
+			run<ForwardListAdapter<T>, T>(settings, report, n);
+		}
+	}
+
+	bool parse(int argc, char* argv[], Settings& settings)
+	{
+		for(int i = 1; i < argc; ++i)
+		{
+			if(i + 1 < argc && std::strcmp(argv[i], "--max-size") == 0)
+			{
+				settings.maxSize = std::strtoull(argv[++i], nullptr, 10);
+			}
+			else if(i + 1 < argc && std::strcmp(argv[i], "--budget") == 0)
+			{
+				settings.budget = std::strtoull(argv[++i], nullptr, 10);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return settings.maxSize >= 10 && settings.maxSize <= 100000000 && settings.budget > 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Settings settings;
+	if(!parse(argc, argv, settings))
+	{
+		std::fprintf(stderr, "usage: %s [--max-size 10..100000000] [--budget element-steps]\n", argv[0]);
+		return 1;
+	}
+
+	Report report;
+	runType<int>(settings, report);
+	runType<std::string>(settings, report);
+	runType<Pod64>(settings, report);
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+//============================================================================
+// Name        : LockFreeQueueBenchmark.cpp
+// Description : Contention benchmark, LockFreeQueue against a mutex protected LinkedList
+//
+// Build: g++ -std=c++20 -O2 -pthread bench/LockFreeQueueBenchmark.cpp -o LockFreeQueueBenchmark
+// Run:   ./LockFreeQueueBenchmark [operations per thread]
+//
+// Every thread alternates push and pop, so the queue stays short and all threads hammer the head and tail. Prints
+// one line per thread count (1 to 64) with the throughput of both queues in million operations per second.
+//============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../include/LinkedList.hpp"
+#include "../include/LockFreeQueue.hpp"
+
+namespace
+{
+	// What the job dispatcher uses today
+	class MutexQueue
+	{
+		public:
+			void push(long val)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mList.push_back(val);
+			}
+
+			std::optional<long> try_pop()
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				if(mList.empty())
+				{
+					return std::nullopt;
+				}
+
+				return mList.pop_front();
+			}
+
+		private:
+			std::mutex mMutex;
+			LinkedList<long> mList;
+	};
+
+	// Million operations (pushes + pops) per second with threadCount threads
+	template<typename Queue>
+	double run(std::size_t threadCount, long operations)
+	{
+		Queue queue;
+		std::vector<std::thread> threads;
+
+		auto start = std::chrono::steady_clock::now();
+
+		for(std::size_t t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&queue, operations]
+			{
+				long sum = 0;
+				for(long i = 0; i < operations; ++i)
+				{
+					queue.push(i);
+					if(std::optional<long> value = queue.try_pop())
+					{
+						sum += *value;
+					}
+				}
+
+				// Keep the pops from being optimized away
+				if(sum == -1)
+				{
+					std::puts("");
+				}
+			});
+		}
+
+		for(std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		return static_cast<double>(2 * operations) * static_cast<double>(threadCount) / elapsed.count() / 1e6;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	long operations = (argc > 1) ? std::atol(argv[1]) : 200000;
+
+	std::printf("threads  lockfree_mops  mutex_mops\n");
+	for(std::size_t threads : {1, 2, 4, 8, 16, 32, 64})
+	{
+		double lockFree = run<LockFreeQueue<long>>(threads, operations);
+		double mutex = run<MutexQueue>(threads, operations);
+		std::printf("%7zu  %13.2f  %10.2f\n", threads, lockFree, mutex);
+	}
+
+	return 0;
+}
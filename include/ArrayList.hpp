@@ -1,235 +1,104 @@
 #ifndef INCLUDE_ARRAYARRAYLIST_HPP_
 #define INCLUDE_ARRAYARRAYLIST_HPP_
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
 
-#define UNIT_TEST 1
-
-#ifdef UNIT_TEST
-#include <iostream>
-#endif
+#include "ContiguousIterator.hpp"
+#include "GrowthPolicy.hpp"
+#include "Instrumentation.hpp"
+#include "Relocatable.hpp"
+#include "SimdSearch.hpp"
 
 /**
  * Access:  O(1) (array lookup)
  * Insert:  O(n) (might have to shift all elements to right)
  * Removal: O(n) (might have to shift all elements to left)
  * Add:     O(n) (list could be full and have to copy everything)
+ *
+ * Storage comes from Allocator and is kept uninitialized. Only the live elements [0, size()) are ever constructed,
+ * spare capacity is raw memory. An empty list owns no buffer at all.
+ *
+ * Shifting on insert/erase and moving into a new buffer relocate the elements (see Relocatable.hpp). For trivially
+ * relocatable types that is a single memmove.
+ *
+ * How far the buffer grows and when it shrinks again is up to GrowthPolicy (see GrowthPolicy.hpp).
+ *
+ * Instrumentation gets told about copies, moves and reallocations and stats() reports them. The default policy
+ * compiles away entirely (see Instrumentation.hpp).
  */
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+         typename Instrumentation = NoInstrumentation>
 class ArrayList
 {
 	public:
-		class iterator
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = ContiguousIterator<T>;
+		using const_iterator         = ContiguousIterator<const T>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Default constructor. Does not allocate, storage is only acquired on the first insert.
+		ArrayList() noexcept(noexcept(Allocator()))
 		{
-			// Do not inherit from std::iterator it is deprecated in c++17
-		    using value_type = T;
-		    using pointer    = T*;
-		    using reference  = T&;
-		    using difference_type = std::ptrdiff_t;
-
-			// Iteration Type:
-			//   - Random AccessIterator
-			//     - Bidirectional Iterator
-			//       - Forward Iterator
-			//         - Output Iterator
-			//         - Input Iterator
-		    using iterator_category = std::random_access_iterator_tag;
-
-		    // Pretty sure we could also do:
-//		    typedef T                               value_type;
-//		    typedef std::ptrdiff_t                  difference_type;
-//		    typedef T*                              pointer;
-//		    typedef T&                              reference;
-//		    typedef std::random_access_iterator_tag iterator_category;
-
-		    iterator() = default;
-
-		    iterator(ArrayList<T>* data, size_t index)
-		    {
-		    	mData = data;
-		    	mCurrentIndex = index;
-		    }
-		    // Default Copy/Move Are Fine.
-		    // Default Destructor fine.
-
-		    reference operator*()
-		    {
-		    	return (*mData)[mCurrentIndex];
-		    }
-
-		    const reference operator*() const
-		    {
-		    	return (*mData)[mCurrentIndex];
-		    }
-
-		    pointer operator->()
-		    {
-		    	return &((*mData)[mCurrentIndex]);
-		    }
-
-		    const pointer operator->() const
-		    {
-		    	return &((*mData)[mCurrentIndex]);
-		    }
-
-		    reference operator[](int m)
-		    {
-		    	return (*mData)[mCurrentIndex + m];
-		    }
-
-		    const reference operator[](int m) const
-		    {
-		    	return (*mData)[mCurrentIndex + m];
-		    }
-
-		    // Most of these are canonical
-		    iterator& operator++()
-			{
-		    	++mCurrentIndex;
-		    	return *this;
-			}
-
-		    iterator& operator--()
-			{
-		    	--mCurrentIndex;
-		    	return *this;
-			}
-
-		    // Post increment
-		    // Post increment returns a copy of itself, and THEN increments itself.
-		    iterator operator++(int)
-			{
-		    	iterator other(*this);
-		    	++mCurrentIndex;
-		    	return other;
-			}
-
-		    // Post decrement
-		    // Post decrement returns a copy of itself, and THEN decrements itself.
-		    iterator operator--(int)
-			{
-		    	iterator other(*this);
-		    	--mCurrentIndex;
-		    	return other;
-			}
-
-		    iterator& operator+=(int n)
-			{
-		    	mCurrentIndex += n;
-		    	return *this;
-			}
-
-		    iterator& operator-=(int n)
-			{
-		    	mCurrentIndex -= n;
-		    	return *this;
-			}
-
-		    iterator operator+(int n) const
-		    {
-		    	iterator r(*this);
-		    	return r += n;
-		    }
-
-		    iterator operator-(int n) const
-		    {
-		    	iterator r(*this);
-		    	return r -= n;
-		    }
-
-		    difference_type operator-(iterator const& r) const
-		    {
-		    	return mCurrentIndex - r.mCurrentIndex;
-		    }
-
-		    // Comparing iterator from different containers is undefined behavior so don't check
-		    // These canonical (and maybe not needed?
-		    bool operator<(iterator const& other) const
-		    {
-		    	return mCurrentIndex <  other.mCurrentIndex;
-		    }
-
-		    bool operator<=(iterator const& other) const
-			{
-		    	return mCurrentIndex <= other.mCurrentIndex;
-			}
-
-		    bool operator>(iterator const& other) const
-		    {
-		    	return mCurrentIndex >  other.mCurrentIndex;
-		    }
-
-		    bool operator>=(iterator const& other) const
-			{
-		    	return mCurrentIndex >= other.mCurrentIndex;
-			}
-
-		    bool operator!=(const iterator& other) const
-			{
-		    	return mCurrentIndex != other.mCurrentIndex;
-			}
-
-		    bool operator==(const iterator& other) const
-			{
-		    	return mCurrentIndex == other.mCurrentIndex;
-			}
-
-		private:
-		    ArrayList<T>* mData = nullptr;
-		    size_t        mCurrentIndex = 0;
-		};
+			mInstrumentation.onConstruct();
+		}
 
-		// Default constructor
-		ArrayList()
+		explicit ArrayList(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
 		{
-#ifdef UNIT_TEST
-			std::cout << "Default constructor" << std::endl;
-#endif
+			mInstrumentation.onConstruct();
 		}
 
-		ArrayList(const std::initializer_list<T>& il)
+		ArrayList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
 		{
-#ifdef UNIT_TEST
-			std::cout << "Initializer list constructor" << std::endl;
-#endif
-
-			for(const T& val : il)
-			{
-				this->push_back(val);
-			}
+			mInstrumentation.onConstruct();
+			append(il.begin(), il.end());
 		}
 
 		// User defined constructor
-		ArrayList(T contents[], size_t listSize)
+		ArrayList(T contents[], size_t listSize, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
 		{
-#ifdef UNIT_TEST
-			std::cout << "User defined constructor" << std::endl;
-#endif
+			mInstrumentation.onConstruct();
+			mContents = copyArray(contents, listSize, listSize * 2);
 			mCurrentSize = listSize;
 			mMaxSize = listSize * 2;
-			mContents = copyArray(contents, listSize, mMaxSize);
 		}
 
-		// Copy constructor
-		ArrayList(const ArrayList<T>& other)
+		// Copy constructor. Only the live elements are copied, spare capacity is not carried over.
+		ArrayList(const ArrayList& other)
+			: mAllocator(AllocTraits::select_on_container_copy_construction(other.mAllocator))
 		{
-#ifdef UNIT_TEST
-			std::cout << "Copy constructor" << std::endl;
-#endif
+			mInstrumentation.onConstruct();
+			mContents = copyArray(other.mContents, other.mCurrentSize, other.mCurrentSize);
 			mCurrentSize = other.mCurrentSize;
-			mMaxSize = other.mMaxSize;
-			mContents = copyArray(other.mContents.get(), other.mMaxSize, other.mMaxSize);
+			mMaxSize = other.mCurrentSize;
+			mInstrumentation.onCopy(mCurrentSize * sizeof(T));
 		}
 
 		// Move constructor should never throw
-		ArrayList(ArrayList<T>&& other) noexcept
+		ArrayList(ArrayList&& other) noexcept
+			: mAllocator(std::move(other.mAllocator))
 		{
-#ifdef UNIT_TEST
-			std::cout << "Move constructor" << std::endl;
-#endif
-			forwardMove(std::forward<ArrayList<T>>(other));
+			mInstrumentation.onConstruct();
+			mInstrumentation.onMove();
+			forwardMove(std::forward<ArrayList>(other));
 		}
 
 		/**
@@ -238,15 +107,36 @@ class ArrayList
 		 * function operator=(ArrayList<T>&&) or operator=(ArrayList<T>&) to call. So we lose an optimization
 		 * opportunity because of the temporary copy instead of letting the compiler figure things out in the
 		 * parameter list.
+		 *
+		 * The copy always lives in storage from our own allocator. It only takes over other's allocator when that one
+		 * propagates on copy assignment, and then our old buffer has to go back to the allocator it came from first.
 		 */
-		ArrayList<T>& operator=(const ArrayList<T>& other)
-		{
-#ifdef UNIT_TEST
-			std::cout << "Assignment operator" << std::endl;
-#endif
-			// Get am
-			ArrayList<T> temp = other;
-			swap(*this, temp);
+		ArrayList& operator=(const ArrayList& other)
+		{
+			mInstrumentation.onCopy(other.mCurrentSize * sizeof(T));
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(AllocTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!AllocTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			T* contents = copyArray(other.mContents, other.mCurrentSize, other.mCurrentSize);
+			release();
+			mContents = contents;
+			mCurrentSize = other.mCurrentSize;
+			mMaxSize = other.mCurrentSize;
 			return *this;
 		}
 
@@ -256,48 +146,119 @@ class ArrayList
 		 *  1. Destroy visible resources
 		 *  2. Move assign all members
 		 *  3. If the move assignment members didn't make the rhs resource-less, then do it
+		 *
+		 * The only exception is an allocator that neither propagates nor compares equal. Then we can't adopt the
+		 * other buffer and have to move the elements over one by one.
 		 */
-		ArrayList<T>& operator=(ArrayList<T>&& other) noexcept
+		ArrayList& operator=(ArrayList&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+		                                                 AllocTraits::is_always_equal::value)
 		{
-#ifdef UNIT_TEST
-			std::cout << "Move assignment operator" << std::endl;
-#endif
+			mInstrumentation.onMove();
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(AllocTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!AllocTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					mContents = copyArray<true>(other.mContents, other.mCurrentSize, other.mCurrentSize);
+					mCurrentSize = other.mCurrentSize;
+					mMaxSize = other.mCurrentSize;
+					other.release();
+					return *this;
+				}
+			}
+
 			// Don't want to swap. Temporary variable is going away and assigning something to it would be strange
 			// behavior.
 			// Also we forward other because && doesn't always mean rvalue reference, it could be a
 			// forwarding reference (universal reference).
-			forwardMove(std::forward<ArrayList<T>>(other));
+			forwardMove(std::forward<ArrayList>(other));
 			return *this;
 		}
 
 		// Comparison operators - non member functions
 
+		// Iterators:
+		// Plain pointers underneath, invalidated by anything that reallocates.
 
+		iterator begin() noexcept
+		{
+			return iterator(mContents);
+		}
 
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mContents);
+		}
 
-//	    iterator begin()
-//	    {
-//
-//	    }
-//
-//	    const iterator cbegin()
-//		{
-//
-//		}
-//
-//	    rbegin()
-//	    crbegin()
-//	    end()
-//	    cend()
-//	    rend()
-//	    crend()
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(mContents + mCurrentSize);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(mContents + mCurrentSize);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
 
-		virtual ~ArrayList() noexcept = default;
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator crbegin() const noexcept
+		{
+			return rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_reverse_iterator crend() const noexcept
+		{
+			return rend();
+		}
+
+		virtual ~ArrayList() noexcept
+		{
+			release();
+		}
 
 		/**
 		 * Swap function should never throw
 		 */
-		friend void swap(ArrayList<T>& left, ArrayList<T>& right) noexcept
+		friend void swap(ArrayList& left, ArrayList& right) noexcept
 		{
 			// We always just want to call swap and be done with it. We don't want swap to be a member function. So we
 			// enable ADL (argument dependent lookup) and when we call swap it will find our friend function because
@@ -308,6 +269,22 @@ class ArrayList
 			std::swap(left.mCurrentSize, right.mCurrentSize);
 			std::swap(left.mMaxSize, right.mMaxSize);
 			std::swap(left.mContents, right.mContents);
+
+			if constexpr(AllocTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return mAllocator;
+		}
+
+		// Counters from the Instrumentation policy. All zero with the default NoInstrumentation.
+		ContainerStats stats() const noexcept
+		{
+			return mInstrumentation.stats();
 		}
 
 		// Capacity:
@@ -318,7 +295,7 @@ class ArrayList
 
 		size_t max_size() const noexcept
 		{
-			return std::numeric_limits<size_t>::max();
+			return AllocTraits::max_size(mAllocator);
 		}
 
 		size_t capacity() const noexcept
@@ -331,16 +308,44 @@ class ArrayList
 			return (mCurrentSize == 0);
 		}
 
+		/**
+		 * Make room for at least newCapacity elements without reallocating. Never shrinks.
+		 */
+		void reserve(size_t newCapacity) // throw length_error
+		{
+			if(newCapacity > max_size())
+			{
+				throw std::length_error("Capacity exceeds max_size");
+			}
+
+			if(newCapacity > mMaxSize)
+			{
+				reallocate(newCapacity);
+			}
+		}
+
+		/**
+		 * Drop all spare capacity. An empty list gives its buffer back entirely.
+		 */
+		void shrink_to_fit()
+		{
+			if(mMaxSize > mCurrentSize)
+			{
+				reallocate(mCurrentSize);
+			}
+		}
+
 		// Element access:
+		// Only [0, size()) holds constructed objects, everything past that is raw memory.
 
 		T& operator[] (size_t index) // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->operator[](index));
+			return const_cast<T&>(static_cast<const ArrayList*>(this)->operator[](index));
 		}
 
 		const T& operator[] (size_t index) const // throw out_of_range
 		{
-			if(index > mMaxSize)
+			if(index >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
@@ -350,12 +355,12 @@ class ArrayList
 
 		T& at(size_t index) // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->at(index));
+			return const_cast<T&>(static_cast<const ArrayList*>(this)->at(index));
 		}
 
 		const T& at(size_t index) const // throw out_of_range
 		{
-			if(index > mMaxSize)
+			if(index >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
@@ -365,7 +370,7 @@ class ArrayList
 
 		T& front()
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->front());
+			return const_cast<T&>(static_cast<const ArrayList*>(this)->front());
 		}
 
 		const T& front() const
@@ -380,7 +385,7 @@ class ArrayList
 
 		T& back() // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->back());
+			return const_cast<T&>(static_cast<const ArrayList*>(this)->back());
 		}
 
 		const T& back() const // throw out_of_range
@@ -395,12 +400,12 @@ class ArrayList
 
 		T* data() noexcept
 		{
-			return mContents.get();
+			return mContents;
 		}
 
 		const T* data() const noexcept
 		{
-			return static_cast<const T*>(mContents->get());
+			return mContents;
 		}
 
 		// Modifiers
@@ -412,83 +417,147 @@ class ArrayList
 
 		void push_front (T&& val)
 		{
-			insert(val, 0);
+			insert(std::move(val), 0);
 		}
 
 		void push_back (const T& val)
 		{
-			insert(val, mCurrentSize);
+			emplaceAt(mCurrentSize, val);
 		}
 
 		void push_back (T&& val)
 		{
-			insert(val, mCurrentSize);
+			emplaceAt(mCurrentSize, std::move(val));
 		}
 
-		T pop_front()
+		/**
+		 * Construct an element in place at the end from args. Returns the new element.
+		 */
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
 		{
-			return erase(0);
+			return emplaceAt(mCurrentSize, std::forward<Args>(args)...);
 		}
 
-		T pop_back()
+		/**
+		 * Construct an element in place at insertIndex from args, shifting everything after it right. Returns the
+		 * new element.
+		 */
+		template<typename... Args>
+		T& emplace(std::size_t insertIndex, Args&&... args) // throw out_of_range
 		{
-			return erase(mCurrentSize);
+			return emplaceAt(insertIndex, std::forward<Args>(args)...);
 		}
 
-		void insert(const T& val, std::size_t insertIndex)
+		/**
+		 * Bulk modifiers. Each of these works out the final size up front, grows the buffer at most once and shifts
+		 * the tail at most once. Trivially copyable elements are copied in with memcpy when the source is contiguous.
+		 *
+		 * Plain input iterators can only be walked once so there's no way to size them up front. Those fall back to
+		 * one push_back per element.
+		 *
+		 * As with std::vector, iterators into this list are only allowed as the source when they're contiguous
+		 * (iterator, const_iterator, pointers, spans).
+		 */
+
+		template<std::input_iterator It>
+		void append(It first, It last)
 		{
-			if(insertIndex > mCurrentSize)
-			{
-				throw std::out_of_range("Index out of bounds");
-			}
+			insert(mCurrentSize, first, last);
+		}
 
-			// Start at the right and move everything over by 1 until we get to our position we want to insert
-			for(size_t i = mCurrentSize; i > insertIndex; i--)
+		void append(std::span<const T> values)
+		{
+			insertRange(mCurrentSize, values.begin(), values.size());
+		}
+
+		template<std::input_iterator It>
+		void insert(std::size_t insertIndex, It first, It last) // throw out_of_range
+		{
+			if constexpr(std::forward_iterator<It>)
 			{
-				std::swap(mContents[i], mContents[i-1]);
+				insertRange(insertIndex, first, static_cast<size_t>(std::distance(first, last)));
 			}
-
-			mContents[insertIndex] = val;
-			mCurrentSize++;
-
-			if(mCurrentSize == mMaxSize)
+			else
 			{
-				mMaxSize = mMaxSize * 2;
-				mContents = copyArray(mContents.get(), mCurrentSize, mMaxSize);
+				if(insertIndex > mCurrentSize)
+				{
+					throw std::out_of_range("Index out of bounds");
+				}
+
+				for(; first != last; ++first)
+				{
+					emplaceAt(insertIndex++, *first);
+				}
 			}
 		}
 
-		void insert(T&& val, std::size_t insertIndex)
+		template<std::input_iterator It>
+		void assign(It first, It last)
 		{
-			if(insertIndex > mCurrentSize)
+			if constexpr(std::forward_iterator<It>)
 			{
-				throw std::out_of_range("Index out of bounds");
+				assignRange(first, static_cast<size_t>(std::distance(first, last)));
 			}
-
-			// Start at the right and move everything over by 1 until we get to our position we want to insert
-			for(size_t i = mCurrentSize; i > insertIndex; i--)
+			else
 			{
-				std::swap(mContents[i], mContents[i-1]);
+				clear();
+				insert(0, first, last);
 			}
+		}
 
-			mContents[insertIndex] = std::move(val);
-			mCurrentSize++;
+		void assign(std::span<const T> values)
+		{
+			assignRange(values.begin(), values.size());
+		}
 
-			if(mCurrentSize == mMaxSize)
-			{
-				mMaxSize = mMaxSize * 2;
-				mContents = copyArray(mContents.get(), mCurrentSize, mMaxSize);
-			}
+		void assign(std::initializer_list<T> il)
+		{
+			assignRange(il.begin(), il.size());
+		}
+
+		/**
+		 * Destroy every element. The buffer is kept, use shrink_to_fit() to give it back.
+		 */
+		void clear() noexcept
+		{
+			destroy(mContents, mContents + mCurrentSize);
+			mCurrentSize = 0;
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(mCurrentSize - 1);
+		}
+
+		void insert(const T& val, std::size_t insertIndex)
+		{
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex)
+		{
+			emplaceAt(insertIndex, std::move(val));
 		}
 
 		void replace(const T& val, std::size_t insertIndex)
 		{
-			replace(std::forward(val), insertIndex);
+			if(insertIndex >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			mContents[insertIndex] = val;
 		}
 
 		void replace(T&& val, std::size_t insertIndex)
 		{
-			if(insertIndex > mCurrentSize)
+			if(insertIndex >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
@@ -503,26 +572,33 @@ class ArrayList
 				throw std::out_of_range("Empty list");
 			}
 
-			if(index > mCurrentSize)
+			if(index >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
 
 			T removed = std::move(mContents[index]);
 
-			// Start at the removal point, and copy everything left by 1
-			for(std::size_t i = index; i < mCurrentSize - 1; ++i)
+			if constexpr(detail::is_relocatable_v<T>)
 			{
-				std::swap(mContents[i], mContents[i+1]);
+				// Drop the husk and slide the tail left over the hole
+				AllocTraits::destroy(mAllocator, mContents + index);
+				detail::relocate(mAllocator, mContents + index + 1, mContents + mCurrentSize, mContents + index);
+			}
+			else
+			{
+				// Start at the removal point, and move everything left by 1. The last slot is then a moved from husk
+				// that gets destroyed so that slot goes back to being raw memory.
+				std::move(mContents + index + 1, mContents + mCurrentSize, mContents + index);
+				AllocTraits::destroy(mAllocator, mContents + mCurrentSize - 1);
 			}
 
-			mMaxSize--;
 			mCurrentSize--;
 
-			// Shrink max amount
-			if(mMaxSize / 4 > mCurrentSize)
+			size_t shrunk = GrowthPolicy::shrink(mMaxSize, mCurrentSize, sizeof(T));
+			if(shrunk < mMaxSize)
 			{
-				mContents = copyArray(mContents.get(), mCurrentSize, mMaxSize / 2);
+				reallocate(shrunk);
 			}
 
 			return removed;
@@ -531,26 +607,68 @@ class ArrayList
 		void remove(const T& val)
 		{
 			size_t index = find(val);
-			if( index != mMaxSize)
+			if( index != mCurrentSize)
 			{
 				erase(index);
 			}
 		}
 
+		/**
+		 * Return index of the first element equal to val, or size() if there is none. 32/64 bit integers, float and
+		 * double are searched with SIMD (see SimdSearch.hpp).
+		 */
 		size_t find(const T& val) const
 		{
-			int index = mCurrentSize;
-
-			for(size_t i = 0; i < mCurrentSize; ++i)
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::find(mContents, mCurrentSize, val);
+			}
+			else
 			{
-				if(val == mContents[i])
+				size_t index = mCurrentSize;
+
+				for(size_t i = 0; i < mCurrentSize; ++i)
 				{
-					index = i;
-					break;
+					if(val == mContents[i])
+					{
+						index = i;
+						break;
+					}
 				}
+
+				return index;
 			}
+		}
 
-			return index;
+		/**
+		 * Return index of the first element the predicate accepts, or size() if there is none. For arithmetic types
+		 * the predicate is evaluated a block at a time so simple predicates vectorize. It may then be called on
+		 * elements past the match, so it must not have side effects.
+		 */
+		template<typename Predicate>
+		size_t find_if(Predicate predicate) const
+		{
+			if constexpr(std::is_arithmetic_v<T>)
+			{
+				return simd::find_if(mContents, mCurrentSize, predicate);
+			}
+			else
+			{
+				return static_cast<size_t>(std::find_if(begin(), end(), predicate) - begin());
+			}
+		}
+
+		// Number of elements equal to val
+		size_t count(const T& val) const
+		{
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::count(mContents, mCurrentSize, val);
+			}
+			else
+			{
+				return static_cast<size_t>(std::count(begin(), end(), val));
+			}
 		}
 
 		bool contains(const T& data) const
@@ -618,29 +736,378 @@ class ArrayList
 	// //  }
 
 	private:
-		std::unique_ptr<T[]> copyArray(T contents[], size_t listSize, size_t maxSize)
+		using AllocTraits = std::allocator_traits<Allocator>;
+
+		T* allocate(size_t count)
+		{
+			return (count == 0) ? nullptr : AllocTraits::allocate(mAllocator, count);
+		}
+
+		void deallocate(T* contents, size_t count) noexcept
+		{
+			if(contents != nullptr)
+			{
+				AllocTraits::deallocate(mAllocator, contents, count);
+			}
+		}
+
+		void destroy(T* first, T* last) noexcept
+		{
+			for(; first != last; ++first)
+			{
+				AllocTraits::destroy(mAllocator, first);
+			}
+		}
+
+		// Destroys every live element and hands the buffer back to the allocator. Leaves the list empty.
+		void release() noexcept
+		{
+			destroy(mContents, mContents + mCurrentSize);
+			deallocate(mContents, mMaxSize);
+			mContents = nullptr;
+			mCurrentSize = 0;
+			mMaxSize = 0;
+		}
+
+		/**
+		 * Copy (or move when MoveElements is set) listSize elements into a fresh buffer with room for maxSize. Only
+		 * the first listSize slots are constructed. If one of the element constructors throws, everything built so
+		 * far is torn down again and the new buffer is released.
+		 */
+		template<bool MoveElements = false>
+		T* copyArray(T contents[], size_t listSize, size_t maxSize)
 		{
-			std::unique_ptr<T[]> copy = std::make_unique<T[]>(maxSize);
+			T* copy = allocate(maxSize);
+			T* built = copy;
 
-			for(std::size_t i = 0; i < listSize; ++i)
+			try
 			{
-				copy[i] = contents[i];
+				for(std::size_t i = 0; i < listSize; ++i, ++built)
+				{
+					if constexpr(MoveElements)
+					{
+						AllocTraits::construct(mAllocator, built, std::move_if_noexcept(contents[i]));
+					}
+					else
+					{
+						AllocTraits::construct(mAllocator, built, std::as_const(contents[i]));
+					}
+				}
+			}
+			catch(...)
+			{
+				destroy(copy, built);
+				deallocate(copy, maxSize);
+				throw;
 			}
 
 			return copy;
 		}
 
-		void forwardMove(ArrayList<T> && other)
+		void reallocate(size_t maxSize)
+		{
+			T* contents = nullptr;
+
+			if constexpr(detail::is_relocatable_v<T>)
+			{
+				contents = allocate(maxSize);
+				detail::relocate(mAllocator, mContents, mContents + mCurrentSize, contents);
+			}
+			else
+			{
+				contents = copyArray<true>(mContents, mCurrentSize, maxSize);
+				destroy(mContents, mContents + mCurrentSize);
+			}
+
+			deallocate(mContents, mMaxSize);
+			mContents = contents;
+			mMaxSize = maxSize;
+			mInstrumentation.onReallocate(mCurrentSize * sizeof(T));
+		}
+
+		/**
+		 * Construct a new element from args at insertIndex. args may refer to elements of this list so they are only
+		 * consumed while everything they could point at is still in place.
+		 */
+		template<typename... Args>
+		T& emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			if(mCurrentSize == mMaxSize)
+			{
+				size_t maxSize = GrowthPolicy::grow(mMaxSize, mCurrentSize + 1, sizeof(T));
+
+				if constexpr(detail::is_relocatable_v<T>)
+				{
+					// Build the new element straight into the new buffer while the old one is still intact, then
+					// relocate the rest around it.
+					T* contents = allocate(maxSize);
+
+					try
+					{
+						AllocTraits::construct(mAllocator, contents + insertIndex, std::forward<Args>(args)...);
+					}
+					catch(...)
+					{
+						deallocate(contents, maxSize);
+						throw;
+					}
+
+					detail::relocate(mAllocator, mContents, mContents + insertIndex, contents);
+					detail::relocate(mAllocator, mContents + insertIndex, mContents + mCurrentSize,
+					                 contents + insertIndex + 1);
+					deallocate(mContents, mMaxSize);
+					mContents = contents;
+					mMaxSize = maxSize;
+					mInstrumentation.onReallocate(mCurrentSize * sizeof(T));
+					mCurrentSize++;
+					return mContents[insertIndex];
+				}
+				else
+				{
+					// Grab the value before the old buffer goes away, args could be one of our own elements.
+					T temp(std::forward<Args>(args)...);
+					reallocate(maxSize);
+					return emplaceAt(insertIndex, std::move(temp));
+				}
+			}
+
+			if(insertIndex == mCurrentSize)
+			{
+				AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::forward<Args>(args)...);
+			}
+			else
+			{
+				// args could point into the part we're about to shift so build the element first
+				T temp(std::forward<Args>(args)...);
+
+				if constexpr(detail::is_relocatable_v<T>)
+				{
+					// Slide the tail right by one in one go which leaves a raw slot at insertIndex
+					detail::relocate(mAllocator, mContents + insertIndex, mContents + mCurrentSize,
+					                 mContents + insertIndex + 1);
+					AllocTraits::construct(mAllocator, mContents + insertIndex, std::move(temp));
+				}
+				else
+				{
+					// The last slot is raw memory so it has to be constructed, everything else is assigned. Start at
+					// the right and move everything over by 1 until we get to our position we want to insert
+					AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::move(mContents[mCurrentSize - 1]));
+					std::move_backward(mContents + insertIndex, mContents + mCurrentSize - 1, mContents + mCurrentSize);
+					mContents[insertIndex] = std::move(temp);
+				}
+			}
+
+			mCurrentSize++;
+			return mContents[insertIndex];
+		}
+
+		// True when [first, first + count) is a piece of our own buffer. Only contiguous iterators can tell us.
+		template<typename It>
+		bool aliases(It first, size_t count) const noexcept
+		{
+			if constexpr(std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, T>)
+			{
+				const T* source = std::to_address(first);
+				return count != 0 && std::less_equal<const T*>()(mContents, source) &&
+				       std::less<const T*>()(source, mContents + mCurrentSize);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		/**
+		 * Copy count elements starting at first into raw memory at dest. memcpy when we can, otherwise one
+		 * constructor per element. If a constructor throws everything built so far is destroyed again.
+		 */
+		template<typename It>
+		void constructRange(T* dest, It first, size_t count)
+		{
+			if constexpr(std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> &&
+			             std::is_same_v<std::iter_value_t<It>, T>)
+			{
+				if(count != 0)
+				{
+					std::memcpy(static_cast<void*>(dest), std::to_address(first), count * sizeof(T));
+				}
+			}
+			else
+			{
+				size_t built = 0;
+
+				try
+				{
+					for(; built < count; ++built, ++first)
+					{
+						AllocTraits::construct(mAllocator, dest + built, *first);
+					}
+				}
+				catch(...)
+				{
+					destroy(dest, dest + built);
+					throw;
+				}
+			}
+		}
+
+		template<typename It>
+		void insertRange(std::size_t insertIndex, It first, size_t count)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			if(count == 0)
+			{
+				return;
+			}
+
+			if constexpr(detail::is_relocatable_v<T>)
+			{
+				if(mCurrentSize + count > mMaxSize || aliases(first, count))
+				{
+					// Copy the new elements into a fresh buffer first, while the source is guaranteed to still be in
+					// one piece, then relocate our elements around them.
+					size_t maxSize = (mCurrentSize + count > mMaxSize)
+					                 ? GrowthPolicy::grow(mMaxSize, mCurrentSize + count, sizeof(T))
+					                 : mMaxSize;
+					T* contents = allocate(maxSize);
+
+					try
+					{
+						constructRange(contents + insertIndex, first, count);
+					}
+					catch(...)
+					{
+						deallocate(contents, maxSize);
+						throw;
+					}
+
+					detail::relocate(mAllocator, mContents, mContents + insertIndex, contents);
+					detail::relocate(mAllocator, mContents + insertIndex, mContents + mCurrentSize,
+					                 contents + insertIndex + count);
+					deallocate(mContents, mMaxSize);
+					mContents = contents;
+					mMaxSize = maxSize;
+					mInstrumentation.onReallocate(mCurrentSize * sizeof(T));
+				}
+				else
+				{
+					// Open a hole of count raw slots and fill it. Relocation can't throw so if the copy does we can
+					// close the hole again.
+					T* hole = mContents + insertIndex;
+					detail::relocate(mAllocator, hole, mContents + mCurrentSize, hole + count);
+
+					try
+					{
+						constructRange(hole, first, count);
+					}
+					catch(...)
+					{
+						detail::relocate(mAllocator, hole + count, mContents + mCurrentSize + count, hole);
+						throw;
+					}
+				}
+
+				mCurrentSize += count;
+			}
+			else
+			{
+				// Moves can throw so every slot has to hold an object at all times. Copy the source out first (it
+				// could be us), make room, then shift by assignment.
+				ArrayList values(mAllocator);
+				values.reserve(count);
+				values.constructRange(values.mContents, first, count);
+				values.mCurrentSize = count;
+
+				if(mCurrentSize + count > mMaxSize)
+				{
+					reallocate(GrowthPolicy::grow(mMaxSize, mCurrentSize + count, sizeof(T)));
+				}
+
+				T* position = mContents + insertIndex;
+				T* oldEnd = mContents + mCurrentSize;
+				size_t tail = mCurrentSize - insertIndex;
+
+				if(tail > count)
+				{
+					// The last count elements move into raw memory, the rest of the tail shifts over live slots
+					for(size_t i = 0; i < count; ++i)
+					{
+						AllocTraits::construct(mAllocator, oldEnd + i, std::move(*(oldEnd - count + i)));
+						mCurrentSize++;
+					}
+
+					std::move_backward(position, oldEnd - count, oldEnd);
+					std::move(values.mContents, values.mContents + count, position);
+				}
+				else
+				{
+					// The new elements reach past the old end. The overhang goes into raw memory, then the whole tail
+					// behind it, and the rest of the new elements are assigned over the old tail slots.
+					for(size_t i = tail; i < count; ++i)
+					{
+						AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::move(values.mContents[i]));
+						mCurrentSize++;
+					}
+
+					for(size_t i = 0; i < tail; ++i)
+					{
+						AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::move(position[i]));
+						mCurrentSize++;
+					}
+
+					std::move(values.mContents, values.mContents + tail, position);
+				}
+			}
+		}
+
+		template<typename It>
+		void assignRange(It first, size_t count)
+		{
+			if(aliases(first, count))
+			{
+				ArrayList values(mAllocator);
+				values.insertRange(0, first, count);
+				swap(*this, values);
+				return;
+			}
+
+			clear();
+
+			if(count > mMaxSize)
+			{
+				// Nothing to carry over so there's no point relocating into the new buffer
+				T* contents = allocate(count);
+				deallocate(mContents, mMaxSize);
+				mContents = contents;
+				mMaxSize = count;
+			}
+
+			constructRange(mContents, first, count);
+			mCurrentSize = count;
+		}
+
+		// Adopts the buffer of other. Expects this to already be empty (or freshly constructed).
+		void forwardMove(ArrayList&& other) noexcept
 		{
-			mCurrentSize = std::move(other.mCurrentSize);
-			mMaxSize = std::move(other.mMaxSize);
-			mContents = std::move(other.mContents);
+			mCurrentSize = std::exchange(other.mCurrentSize, 0);
+			mMaxSize = std::exchange(other.mMaxSize, 0);
+			mContents = std::exchange(other.mContents, nullptr);
 		}
 
-		static constexpr size_t DEFAULT_CAPACITY = 8;
 		size_t mCurrentSize = 0;
-		size_t mMaxSize = DEFAULT_CAPACITY;
-		std::unique_ptr<T[]> mContents = std::make_unique<T[]>(DEFAULT_CAPACITY);
+		size_t mMaxSize = 0;
+		T*     mContents = nullptr;
+		[[no_unique_address]] Allocator mAllocator;
+		[[no_unique_address]] Instrumentation mInstrumentation;
 };
 
 // Comparison operators
@@ -654,38 +1121,20 @@ class ArrayList
 //     left operand), it might be useful to make it a member function of its left operand’s type,
 //     if it has to access the operand's private parts.
 
-template<typename T>
-inline bool operator==(const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator==(const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
-	bool same = true;
-
-	if(left.size() == right.size())
-	{
-		for(size_t i = 0; i < left.size(); ++i)
-		{
-			if(left.at(i) != right.at(i))
-			{
-				same = false;
-				break;
-			}
-		}
-	}
-	else
-	{
-		same = false;
-	}
-
-	return same;
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
 }
 
-template<typename T>
-inline bool operator!=(const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator!=(const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
 	return !operator==(left,right);
 }
 
-template<typename T>
-inline bool operator< (const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator< (const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
 	bool lessThan = true;
 
@@ -704,20 +1153,20 @@ inline bool operator< (const ArrayList<T>& left, const ArrayList<T>& right)
 	return lessThan;
 }
 
-template<typename T>
-inline bool operator> (const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator> (const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
 	return  operator< (right,left);
 }
 
-template<typename T>
-inline bool operator<=(const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator<=(const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
 	return !operator> (left,right);
 }
 
-template<typename T>
-inline bool operator>=(const ArrayList<T>& left, const ArrayList<T>& right)
+template<typename T, typename... Policies>
+inline bool operator>=(const ArrayList<T, Policies...>& left, const ArrayList<T, Policies...>& right)
 {
 	return !operator< (left,right);
 }
@@ -0,0 +1,772 @@
+#ifndef INCLUDE_CIRCULARARRAYLIST_HPP_
+#define INCLUDE_CIRCULARARRAYLIST_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstring>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "GrowthPolicy.hpp"
+#include "Relocatable.hpp"
+
+/**
+ * Double ended queue on a ring buffer. The elements occupy [head, head + size) modulo the capacity, so adding or
+ * removing at either end just moves head or size.
+ *
+ * Access:  O(1) (array lookup, index wraps with a mask)
+ * Insert:  O(1) at either end, amortized (growing copies everything once)
+ * Removal: O(1) at either end
+ *
+ * Capacity is always a power of two so wrapping an index is an AND instead of a division. Growing unwraps the
+ * elements into the front of the new buffer. Moving elements to a new buffer relocates them (see Relocatable.hpp) so
+ * T has to be trivially relocatable or nothrow movable.
+ *
+ * The live elements are at most two contiguous runs, spans() hands them out for bulk reads and writes.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class CircularArrayList
+{
+	static_assert(detail::is_relocatable_v<T>, "CircularArrayList moves elements by relocation, T needs a nothrow move");
+
+	template<bool Const>
+	class Iterator;
+
+	public:
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = Iterator<false>;
+		using const_iterator         = Iterator<true>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Default constructor. Does not allocate.
+		CircularArrayList() noexcept(noexcept(Allocator())) = default;
+
+		explicit CircularArrayList(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
+		{
+		}
+
+		CircularArrayList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			reserve(il.size());
+			for(const T& val : il)
+			{
+				push_back(val);
+			}
+		}
+
+		// Copy constructor. The copy starts unwrapped at the front of its buffer.
+		CircularArrayList(const CircularArrayList& other)
+			: mAllocator(AllocTraits::select_on_container_copy_construction(other.mAllocator))
+		{
+			reserve(other.size());
+			for(const T& val : other)
+			{
+				push_back(val);
+			}
+		}
+
+		CircularArrayList(CircularArrayList&& other) noexcept
+			: mAllocator(std::move(other.mAllocator))
+		{
+			swapStorage(*this, other);
+		}
+
+		// Copy assignment. The copy is built with our own allocator (or other's, if it propagates on copy assignment)
+		// and only replaces the current contents once it's complete.
+		CircularArrayList& operator=(const CircularArrayList& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(AllocTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!AllocTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			auto [first, second] = other.spans();
+			CircularArrayList temp(mAllocator);
+			temp.reserve(other.size());
+			temp.append(first);
+			temp.append(second);
+
+			swapStorage(*this, temp);
+			return *this;
+		}
+
+		// Move assignment. Same as ArrayList, an allocator that neither propagates nor compares equal can't take over
+		// the other buffer so the elements are moved over one by one.
+		CircularArrayList& operator=(CircularArrayList&& other) noexcept(
+			AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(AllocTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!AllocTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					reserve(other.size());
+					for(T& val : other)
+					{
+						push_back(std::move(val));
+					}
+
+					other.release();
+					return *this;
+				}
+			}
+
+			swapStorage(*this, other);
+			return *this;
+		}
+
+		virtual ~CircularArrayList() noexcept
+		{
+			release();
+		}
+
+		// Like the standard containers, the allocators have to propagate on swap or compare equal
+		friend void swap(CircularArrayList& left, CircularArrayList& right) noexcept
+		{
+			using std::swap;
+
+			swapStorage(left, right);
+
+			if constexpr(AllocTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return mAllocator;
+		}
+
+		// Iterators:
+		// An iterator is a list and a logical index, so it survives the buffer growing. push_front and pop_front
+		// shift the indexes though, leaving every iterator on the element next to the one it used to point to.
+
+		iterator begin() noexcept
+		{
+			return iterator(this, 0);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(this, 0);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(this, mSize);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(this, mSize);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mSize;
+		}
+
+		size_t max_size() const noexcept
+		{
+			return std::bit_floor(AllocTraits::max_size(mAllocator));
+		}
+
+		size_t capacity() const noexcept
+		{
+			return mMaxSize;
+		}
+
+		bool empty() const noexcept
+		{
+			return mSize == 0;
+		}
+
+		// Make room for at least newCapacity elements, rounded up to a power of two
+		void reserve(size_t newCapacity) // throw length_error
+		{
+			if(newCapacity > max_size())
+			{
+				throw std::length_error("Capacity exceeds max_size");
+			}
+
+			if(newCapacity > mMaxSize)
+			{
+				reallocate(std::bit_ceil(newCapacity));
+			}
+		}
+
+		// Shrink to the smallest power of two that holds every element. An empty list gives its buffer back.
+		void shrink_to_fit()
+		{
+			size_t fitted = (mSize == 0) ? 0 : std::bit_ceil(mSize);
+			if(fitted < mMaxSize)
+			{
+				reallocate(fitted);
+			}
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const CircularArrayList*>(this)->operator[](index));
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return at(index);
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const CircularArrayList*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= mSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return mContents[wrap(mHead + index)];
+		}
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const CircularArrayList*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mContents[mHead];
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const CircularArrayList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mContents[wrap(mHead + mSize - 1)];
+		}
+
+		/**
+		 * The elements in order as (at most) two contiguous runs. The second span is empty unless the elements wrap
+		 * around the end of the buffer.
+		 */
+		std::pair<std::span<T>, std::span<T>> spans() noexcept
+		{
+			size_t first = std::min(mSize, mMaxSize - mHead);
+			return std::make_pair(std::span<T>(mContents + mHead, first), std::span<T>(mContents, mSize - first));
+		}
+
+		std::pair<std::span<const T>, std::span<const T>> spans() const noexcept
+		{
+			size_t first = std::min(mSize, mMaxSize - mHead);
+			return std::make_pair(std::span<const T>(mContents + mHead, first),
+			                      std::span<const T>(mContents, mSize - first));
+		}
+
+		// Modifiers
+
+		void push_front(const T& val)
+		{
+			emplace_front(val);
+		}
+
+		void push_front(T&& val)
+		{
+			emplace_front(std::move(val));
+		}
+
+		void push_back(const T& val)
+		{
+			emplace_back(val);
+		}
+
+		void push_back(T&& val)
+		{
+			emplace_back(std::move(val));
+		}
+
+		template<typename... Args>
+		T& emplace_front(Args&&... args)
+		{
+			if(mSize == mMaxSize)
+			{
+				// args could be one of our elements, don't let it move before we're done with it
+				T temp(std::forward<Args>(args)...);
+				grow(mSize + 1);
+				return emplace_front(std::move(temp));
+			}
+
+			size_t head = wrap(mHead - 1);
+			AllocTraits::construct(mAllocator, mContents + head, std::forward<Args>(args)...);
+			mHead = head;
+			++mSize;
+			return mContents[mHead];
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			if(mSize == mMaxSize)
+			{
+				T temp(std::forward<Args>(args)...);
+				grow(mSize + 1);
+				return emplace_back(std::move(temp));
+			}
+
+			T* slot = mContents + wrap(mHead + mSize);
+			AllocTraits::construct(mAllocator, slot, std::forward<Args>(args)...);
+			++mSize;
+			return *slot;
+		}
+
+		/**
+		 * Copy values to the back, growing at most once. The values land in at most two contiguous runs which are
+		 * filled with memcpy for trivially copyable types.
+		 */
+		void append(std::span<const T> values)
+		{
+			if(values.empty())
+			{
+				return;
+			}
+
+			if(mSize + values.size() > mMaxSize)
+			{
+				if(aliases(values))
+				{
+					// Growing would free the source, go through a copy
+					CircularArrayList temp(mAllocator);
+					temp.append(values);
+					reserve(mSize + values.size());
+					append(temp.spans().first);
+					return;
+				}
+
+				grow(mSize + values.size());
+			}
+
+			size_t tail = wrap(mHead + mSize);
+			size_t first = std::min(values.size(), mMaxSize - tail);
+			constructRun(mContents + tail, values.data(), first);
+
+			try
+			{
+				constructRun(mContents, values.data() + first, values.size() - first);
+			}
+			catch(...)
+			{
+				destroyRun(mContents + tail, first);
+				throw;
+			}
+
+			mSize += values.size();
+		}
+
+		T pop_front() // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			T removed = std::move(mContents[mHead]);
+			AllocTraits::destroy(mAllocator, mContents + mHead);
+			mHead = wrap(mHead + 1);
+			--mSize;
+			return removed;
+		}
+
+		T pop_back() // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			T* slot = mContents + wrap(mHead + mSize - 1);
+			T removed = std::move(*slot);
+			AllocTraits::destroy(mAllocator, slot);
+			--mSize;
+			return removed;
+		}
+
+		/**
+		 * Drop the first count elements without handing them back. Pairs with spans() to consume a batch in place.
+		 */
+		void erase_front(size_t count) // throw out_of_range
+		{
+			if(count > mSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			for(size_t i = 0; i < count; ++i)
+			{
+				AllocTraits::destroy(mAllocator, mContents + wrap(mHead + i));
+			}
+
+			mHead = wrap(mHead + count);
+			mSize -= count;
+		}
+
+		void replace(const T& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = val;
+		}
+
+		void replace(T&& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = std::move(val);
+		}
+
+		// Destroy every element. The buffer is kept, use shrink_to_fit() to give it back.
+		void clear() noexcept
+		{
+			erase_front(mSize);
+			mHead = 0;
+		}
+
+		// Return index of the first element equal to val, or size() if there is none
+		size_t find(const T& val) const
+		{
+			auto [first, second] = spans();
+
+			size_t index = static_cast<size_t>(std::find(first.begin(), first.end(), val) - first.begin());
+			if(index == first.size())
+			{
+				index += static_cast<size_t>(std::find(second.begin(), second.end(), val) - second.begin());
+			}
+
+			return index;
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != mSize;
+		}
+
+	private:
+		using AllocTraits = std::allocator_traits<Allocator>;
+
+		// Capacity is a power of two (or zero, in which case there is nothing to index anyway)
+		size_t wrap(size_t index) const noexcept
+		{
+			return index & (mMaxSize - 1);
+		}
+
+		static void swapStorage(CircularArrayList& left, CircularArrayList& right) noexcept
+		{
+			std::swap(left.mContents, right.mContents);
+			std::swap(left.mMaxSize, right.mMaxSize);
+			std::swap(left.mHead, right.mHead);
+			std::swap(left.mSize, right.mSize);
+		}
+
+		bool aliases(std::span<const T> values) const noexcept
+		{
+			std::less_equal<const T*> lessEqual;
+			return mContents != nullptr && lessEqual(mContents, values.data()) &&
+			       lessEqual(values.data(), mContents + mMaxSize);
+		}
+
+		void constructRun(T* dest, const T* source, size_t count)
+		{
+			if constexpr(std::is_trivially_copyable_v<T>)
+			{
+				if(count != 0)
+				{
+					std::memcpy(static_cast<void*>(dest), static_cast<const void*>(source), count * sizeof(T));
+				}
+			}
+			else
+			{
+				size_t built = 0;
+				try
+				{
+					for(; built < count; ++built)
+					{
+						AllocTraits::construct(mAllocator, dest + built, source[built]);
+					}
+				}
+				catch(...)
+				{
+					destroyRun(dest, built);
+					throw;
+				}
+			}
+		}
+
+		void destroyRun(T* first, size_t count) noexcept
+		{
+			for(size_t i = 0; i < count; ++i)
+			{
+				AllocTraits::destroy(mAllocator, first + i);
+			}
+		}
+
+		void release() noexcept
+		{
+			clear();
+			if(mContents != nullptr)
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = nullptr;
+			mMaxSize = 0;
+		}
+
+		void grow(size_t required)
+		{
+			reserve(std::max(required, (mMaxSize == 0) ? detail::DEFAULT_CAPACITY : mMaxSize * 2));
+		}
+
+		// Unwrap the elements into the front of a buffer of maxSize (a power of two)
+		void reallocate(size_t maxSize)
+		{
+			T* contents = (maxSize == 0) ? nullptr : AllocTraits::allocate(mAllocator, maxSize);
+
+			auto [first, second] = spans();
+			detail::relocate(mAllocator, first.data(), first.data() + first.size(), contents);
+			detail::relocate(mAllocator, second.data(), second.data() + second.size(), contents + first.size());
+
+			if(mContents != nullptr)
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = contents;
+			mMaxSize = maxSize;
+			mHead = 0;
+		}
+
+		T*     mContents = nullptr;
+		size_t mMaxSize = 0;
+		size_t mHead = 0;
+		size_t mSize = 0;
+		[[no_unique_address]] Allocator mAllocator;
+};
+
+/**
+ * Random access iterator over a CircularArrayList. Holds a logical index, wrapping happens on dereference.
+ */
+template<typename T, typename Allocator>
+template<bool Const>
+class CircularArrayList<T, Allocator>::Iterator
+{
+	using List = std::conditional_t<Const, const CircularArrayList, CircularArrayList>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::random_access_iterator_tag;
+
+		Iterator() = default;
+
+		Iterator(List* list, std::size_t index) noexcept
+			: mList(list), mIndex(index)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mList(other.mList), mIndex(other.mIndex)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return mList->mContents[mList->wrap(mList->mHead + mIndex)];
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &**this;
+		}
+
+		reference operator[](difference_type offset) const noexcept
+		{
+			return *(*this + offset);
+		}
+
+		Iterator& operator++() noexcept
+		{
+			++mIndex;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++mIndex;
+			return previous;
+		}
+
+		Iterator& operator--() noexcept
+		{
+			--mIndex;
+			return *this;
+		}
+
+		Iterator operator--(int) noexcept
+		{
+			Iterator previous = *this;
+			--mIndex;
+			return previous;
+		}
+
+		Iterator& operator+=(difference_type offset) noexcept
+		{
+			mIndex += static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		Iterator& operator-=(difference_type offset) noexcept
+		{
+			mIndex -= static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		friend Iterator operator+(Iterator it, difference_type offset) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator+(difference_type offset, Iterator it) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator-(Iterator it, difference_type offset) noexcept
+		{
+			return it -= offset;
+		}
+
+		friend difference_type operator-(const Iterator& left, const Iterator& right) noexcept
+		{
+			return static_cast<difference_type>(left.mIndex) - static_cast<difference_type>(right.mIndex);
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex == right.mIndex;
+		}
+
+		friend std::strong_ordering operator<=>(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex <=> right.mIndex;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+
+		List* mList = nullptr;
+		std::size_t mIndex = 0;
+};
+
+// Comparison operators
+
+template<typename T, typename Allocator>
+inline bool operator==(const CircularArrayList<T, Allocator>& left, const CircularArrayList<T, Allocator>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename Allocator>
+inline bool operator!=(const CircularArrayList<T, Allocator>& left, const CircularArrayList<T, Allocator>& right)
+{
+	return !operator==(left, right);
+}
+
+#endif /* INCLUDE_CIRCULARARRAYLIST_HPP_ */
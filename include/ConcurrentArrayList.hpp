@@ -0,0 +1,658 @@
+#ifndef INCLUDE_CONCURRENTARRAYLIST_HPP_
+#define INCLUDE_CONCURRENTARRAYLIST_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Append-only list that many threads can push_back to while others read, along the lines of
+ * tbb::concurrent_vector.
+ *
+ * Access:  O(1) (segment lookup + array lookup)
+ * Add:     O(1) (no copying, a new segment is allocated when the last one is full)
+ *
+ * Storage is a table of segments where segment k holds BASE_SIZE << k elements, so there are only a few dozen of them
+ * even for huge lists. A segment is never moved or freed while the list is alive, which means references, pointers
+ * and iterators to elements stay valid no matter what other threads append.
+ *
+ * push_back reserves its slot with a single atomic fetch_add and constructs the element there. Each slot has a state
+ * flag that is published after construction, reading a slot that another thread reserved but hasn't finished
+ * constructing waits for it. size() counts reserved slots, so it may briefly include elements that are still
+ * being constructed.
+ *
+ * Only push_back, emplace_back, grow_by, reserve and the read functions are safe to call concurrently. clear() and
+ * destruction need the list to themselves. Allocator has to be safe to use from several threads at once.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class ConcurrentArrayList
+{
+	// Element storage plus a flag saying whether the element has been constructed yet
+	struct Slot
+	{
+		enum State : std::uint8_t { EMPTY, READY, BROKEN };
+
+		alignas(T) unsigned char storage[sizeof(T)];
+		std::atomic<std::uint8_t> state{EMPTY};
+
+		T* get() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+	};
+
+	using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+	using SlotTraits    = std::allocator_traits<SlotAllocator>;
+
+	template<bool Const>
+	class Iterator;
+
+	public:
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference       = T&;
+		using const_reference = const T&;
+		using iterator        = Iterator<false>;
+		using const_iterator  = Iterator<true>;
+
+		// Elements in the first segment, every segment after it is twice the size of the one before
+		static constexpr std::size_t BASE_SIZE = 8;
+
+		ConcurrentArrayList() = default;
+
+		explicit ConcurrentArrayList(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
+		{
+		}
+
+		ConcurrentArrayList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			reserve(il.size());
+			for(const T& val : il)
+			{
+				push_back(val);
+			}
+		}
+
+		// Copying or moving would have to stop every writer first, which this class can't do
+		ConcurrentArrayList(const ConcurrentArrayList&) = delete;
+		ConcurrentArrayList& operator=(const ConcurrentArrayList&) = delete;
+
+		virtual ~ConcurrentArrayList()
+		{
+			clear();
+
+			for(std::size_t k = 0; k < SEGMENT_COUNT; ++k)
+			{
+				Slot* segment = mSegments[k].load(std::memory_order_relaxed);
+				if(segment != nullptr && segment != failedSegment())
+				{
+					deallocateSegment(segment, segmentSize(k));
+				}
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return allocator_type(mAllocator);
+		}
+
+		// Iterators: (a snapshot of the elements reserved when begin()/end() were called)
+
+		iterator begin() noexcept
+		{
+			return iterator(this, 0);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(this, 0);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(this, size());
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(this, size());
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		// Capacity:
+
+		// Number of reserved slots, including ones another thread is still constructing
+		std::size_t size() const noexcept
+		{
+			return mSize.load(std::memory_order_acquire);
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		// Slots in the segments allocated so far
+		std::size_t capacity() const noexcept
+		{
+			std::size_t k = 0;
+			while(k < SEGMENT_COUNT && isAllocated(mSegments[k].load(std::memory_order_acquire)))
+			{
+				++k;
+			}
+
+			return segmentBase(k);
+		}
+
+		std::size_t max_size() const noexcept
+		{
+			return segmentBase(SEGMENT_COUNT);
+		}
+
+		// Allocate every segment needed to hold newCapacity elements now rather than on the first push into them
+		void reserve(std::size_t newCapacity)
+		{
+			if(newCapacity > max_size())
+			{
+				throw std::length_error("Capacity too large");
+			}
+
+			for(std::size_t k = 0; segmentBase(k) < newCapacity; ++k)
+			{
+				ensureSegment(k);
+			}
+		}
+
+		// Element access:
+		// operator[] and at() wait for an element that is reserved but not constructed yet. Both throw
+		// runtime_error for a slot whose construction failed.
+
+		T& operator[] (std::size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const ConcurrentArrayList*>(this)->operator[](index));
+		}
+
+		const T& operator[] (std::size_t index) const // throw out_of_range
+		{
+			// Anything below size() has been reserved and will show up (or break), past it we'd wait forever
+			if(index >= size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			const T* element = const_cast<ConcurrentArrayList*>(this)->waitFor(index);
+			if(element == nullptr)
+			{
+				throw std::runtime_error("Element construction failed");
+			}
+
+			return *element;
+		}
+
+		T& at(std::size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const ConcurrentArrayList*>(this)->at(index));
+		}
+
+		const T& at(std::size_t index) const // throw out_of_range
+		{
+			return (*this)[index];
+		}
+
+		T& front() // throw out_of_range
+		{
+			return at(0);
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			return at(0);
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const ConcurrentArrayList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			std::size_t currentSize = size();
+			if(currentSize == 0)
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return at(currentSize - 1);
+		}
+
+		// Modifiers
+
+		// Returns the index the element ended up at
+		std::size_t push_back(const T& val)
+		{
+			return emplaceIndex(val);
+		}
+
+		std::size_t push_back(T&& val)
+		{
+			return emplaceIndex(std::move(val));
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			return (*this)[emplaceIndex(std::forward<Args>(args)...)];
+		}
+
+		/**
+		 * Append count copies of val with a single fetch_add, so the new elements sit next to each other in index
+		 * order. Returns the index of the first one.
+		 *
+		 * The indexes can't be handed back, so if a copy throws the ones after it are marked broken before the
+		 * exception is passed on.
+		 */
+		std::size_t grow_by(std::size_t count, const T& val = T())
+		{
+			std::size_t first = mSize.fetch_add(count, std::memory_order_acq_rel);
+			std::size_t i = first;
+
+			try
+			{
+				for(; i < first + count; ++i)
+				{
+					constructAt(i, val);
+				}
+			}
+			catch(...)
+			{
+				// constructAt() already took care of i
+				for(++i; i < first + count; ++i)
+				{
+					abandon(i);
+				}
+
+				throw;
+			}
+
+			return first;
+		}
+
+		/**
+		 * Destroy every element and reset the size. Keeps the segments. Not safe to call while other threads use
+		 * the list.
+		 */
+		void clear() noexcept
+		{
+			std::size_t currentSize = mSize.load(std::memory_order_relaxed);
+			for(std::size_t k = 0; k < SEGMENT_COUNT && segmentBase(k) < currentSize; ++k)
+			{
+				Slot* segment = mSegments[k].load(std::memory_order_relaxed);
+				if(segment == failedSegment())
+				{
+					// Nothing was ever constructed there, let the next push try to allocate it again
+					mSegments[k].store(nullptr, std::memory_order_relaxed);
+					continue;
+				}
+
+				if(segment == nullptr)
+				{
+					continue;
+				}
+
+				std::size_t used = std::min(segmentSize(k), currentSize - segmentBase(k));
+				for(std::size_t i = 0; i < used; ++i)
+				{
+					if(segment[i].state.load(std::memory_order_relaxed) == Slot::READY)
+					{
+						SlotTraits::destroy(mAllocator, segment[i].get());
+					}
+
+					segment[i].state.store(Slot::EMPTY, std::memory_order_relaxed);
+				}
+			}
+
+			mSize.store(0, std::memory_order_release);
+		}
+
+	private:
+		// Enough segments to address every index a size_t can hold
+		static constexpr std::size_t SEGMENT_COUNT = std::numeric_limits<std::size_t>::digits - std::bit_width(BASE_SIZE) + 1;
+
+		static constexpr std::size_t segmentSize(std::size_t k) noexcept
+		{
+			return BASE_SIZE << k;
+		}
+
+		// Index of the first element in segment k: BASE_SIZE * (2^k - 1)
+		static constexpr std::size_t segmentBase(std::size_t k) noexcept
+		{
+			return (k >= SEGMENT_COUNT) ? std::numeric_limits<std::size_t>::max() : BASE_SIZE * ((std::size_t(1) << k) - 1);
+		}
+
+		static constexpr std::size_t segmentOf(std::size_t index) noexcept
+		{
+			return static_cast<std::size_t>(std::bit_width(index / BASE_SIZE + 1)) - 1;
+		}
+
+		/**
+		 * Stands in for a segment that couldn't be allocated after indexes in it had been handed out. Readers of
+		 * those indexes see every slot in it as broken instead of waiting for the segment to show up, and nobody
+		 * allocates it again until clear().
+		 */
+		static Slot* failedSegment() noexcept
+		{
+			static constinit char marker = 0;
+			return reinterpret_cast<Slot*>(&marker);
+		}
+
+		static bool isAllocated(const Slot* segment) noexcept
+		{
+			return segment != nullptr && segment != failedSegment();
+		}
+
+		Slot* allocateSegment(std::size_t count)
+		{
+			Slot* segment = SlotTraits::allocate(mAllocator, count);
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				SlotTraits::construct(mAllocator, segment + i);
+			}
+
+			return segment;
+		}
+
+		void deallocateSegment(Slot* segment, std::size_t count) noexcept
+		{
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				SlotTraits::destroy(mAllocator, segment + i);
+			}
+
+			SlotTraits::deallocate(mAllocator, segment, count);
+		}
+
+		/**
+		 * Segment k, allocating it if nobody has yet. When two threads race to allocate the same segment the loser
+		 * frees its copy and uses the winner's.
+		 */
+		Slot* ensureSegment(std::size_t k)
+		{
+			Slot* segment = mSegments[k].load(std::memory_order_acquire);
+			if(segment == failedSegment())
+			{
+				throw std::bad_alloc();
+			}
+
+			if(segment != nullptr)
+			{
+				return segment;
+			}
+
+			Slot* fresh = allocateSegment(segmentSize(k));
+			if(mSegments[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				return fresh;
+			}
+
+			deallocateSegment(fresh, segmentSize(k));
+			if(segment == failedSegment())
+			{
+				throw std::bad_alloc();
+			}
+
+			return segment;
+		}
+
+		/**
+		 * Give up on a reserved index so nobody waits for it: allocate its segment if needed and mark the slot
+		 * broken. When the segment can't be allocated the whole segment is marked failed instead. Settling that with
+		 * a compare_exchange means a thread that allocates the segment at the same moment either sees the failure
+		 * or we see its segment.
+		 */
+		void abandon(std::size_t index) noexcept
+		{
+			std::size_t k = segmentOf(index);
+
+			Slot* segment = nullptr;
+			try
+			{
+				segment = ensureSegment(k);
+			}
+			catch(...)
+			{
+				if(mSegments[k].compare_exchange_strong(segment, failedSegment(), std::memory_order_acq_rel,
+				                                        std::memory_order_acquire))
+				{
+					return;
+				}
+
+				if(segment == failedSegment())
+				{
+					return;
+				}
+			}
+
+			segment[index - segmentBase(k)].state.store(Slot::BROKEN, std::memory_order_release);
+		}
+
+		template<typename... Args>
+		std::size_t emplaceIndex(Args&&... args)
+		{
+			std::size_t index = mSize.fetch_add(1, std::memory_order_acq_rel);
+			constructAt(index, std::forward<Args>(args)...);
+			return index;
+		}
+
+		template<typename... Args>
+		void constructAt(std::size_t index, Args&&... args)
+		{
+			std::size_t k = segmentOf(index);
+
+			Slot* segment;
+			try
+			{
+				segment = ensureSegment(k);
+			}
+			catch(...)
+			{
+				abandon(index);
+				throw;
+			}
+
+			Slot& slot = segment[index - segmentBase(k)];
+
+			try
+			{
+				SlotTraits::construct(mAllocator, reinterpret_cast<T*>(slot.storage), std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				// The slot can't be given back, mark it so readers don't wait on it forever
+				slot.state.store(Slot::BROKEN, std::memory_order_release);
+				throw;
+			}
+
+			slot.state.store(Slot::READY, std::memory_order_release);
+		}
+
+		// Pointer to the element at index once it's constructed, nullptr if its constructor threw
+		T* waitFor(std::size_t index) noexcept
+		{
+			std::size_t k = segmentOf(index);
+
+			Slot* segment;
+			while((segment = mSegments[k].load(std::memory_order_acquire)) == nullptr)
+			{
+				std::this_thread::yield();
+			}
+
+			if(segment == failedSegment())
+			{
+				return nullptr;
+			}
+
+			Slot& slot = segment[index - segmentBase(k)];
+
+			std::uint8_t state;
+			while((state = slot.state.load(std::memory_order_acquire)) == Slot::EMPTY)
+			{
+				std::this_thread::yield();
+			}
+
+			return (state == Slot::READY) ? slot.get() : nullptr;
+		}
+
+		std::atomic<std::size_t> mSize{0};
+		std::array<std::atomic<Slot*>, SEGMENT_COUNT> mSegments{};
+		[[no_unique_address]] SlotAllocator mAllocator;
+};
+
+/**
+ * Random access iterator over a ConcurrentArrayList. Elements aren't contiguous across segments so this is an index
+ * plus a pointer to the list. Dereferencing waits for the element like operator[].
+ */
+template<typename T, typename Allocator>
+template<bool Const>
+class ConcurrentArrayList<T, Allocator>::Iterator
+{
+	using List = std::conditional_t<Const, const ConcurrentArrayList, ConcurrentArrayList>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::random_access_iterator_tag;
+
+		Iterator() = default;
+
+		Iterator(List* list, std::size_t index) noexcept
+			: mList(list), mIndex(index)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mList(other.mList), mIndex(other.mIndex)
+		{
+		}
+
+		reference operator*() const
+		{
+			return (*mList)[mIndex];
+		}
+
+		pointer operator->() const
+		{
+			return &(*mList)[mIndex];
+		}
+
+		reference operator[](difference_type offset) const
+		{
+			return (*mList)[mIndex + static_cast<std::size_t>(offset)];
+		}
+
+		Iterator& operator++() noexcept
+		{
+			++mIndex;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++mIndex;
+			return previous;
+		}
+
+		Iterator& operator--() noexcept
+		{
+			--mIndex;
+			return *this;
+		}
+
+		Iterator operator--(int) noexcept
+		{
+			Iterator previous = *this;
+			--mIndex;
+			return previous;
+		}
+
+		Iterator& operator+=(difference_type offset) noexcept
+		{
+			mIndex += static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		Iterator& operator-=(difference_type offset) noexcept
+		{
+			mIndex -= static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		friend Iterator operator+(Iterator it, difference_type offset) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator+(difference_type offset, Iterator it) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator-(Iterator it, difference_type offset) noexcept
+		{
+			return it -= offset;
+		}
+
+		friend difference_type operator-(const Iterator& left, const Iterator& right) noexcept
+		{
+			return static_cast<difference_type>(left.mIndex) - static_cast<difference_type>(right.mIndex);
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex == right.mIndex;
+		}
+
+		friend std::strong_ordering operator<=>(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex <=> right.mIndex;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+
+		List* mList = nullptr;
+		std::size_t mIndex = 0;
+};
+
+#endif /* INCLUDE_CONCURRENTARRAYLIST_HPP_ */
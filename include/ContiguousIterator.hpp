@@ -0,0 +1,145 @@
+#ifndef INCLUDE_CONTIGUOUSITERATOR_HPP_
+#define INCLUDE_CONTIGUOUSITERATOR_HPP_
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * Iterator over a block of contiguous elements, used by ArrayList and friends. It's a thin wrapper around a T* so
+ * everything compiles down to plain pointer arithmetic, but unlike a raw pointer it can't be mixed up with some
+ * unrelated pointer. The const iterator is ContiguousIterator<const T> and a mutable iterator converts to it.
+ *
+ * No bounds checks. Like any other iterator it is invalidated when the container reallocates.
+ */
+template<typename T>
+class ContiguousIterator
+{
+	public:
+		// Do not inherit from std::iterator it is deprecated in c++17
+		using value_type      = std::remove_cv_t<T>;
+		using element_type    = T;
+		using pointer         = T*;
+		using reference       = T&;
+		using difference_type = std::ptrdiff_t;
+
+		// Iteration Type:
+		//   - Contiguous Iterator (c++20, elements are laid out next to each other in memory)
+		//     - Random AccessIterator
+		//       - Bidirectional Iterator
+		//         - Forward Iterator
+		//           - Output Iterator
+		//           - Input Iterator
+		using iterator_concept  = std::contiguous_iterator_tag;
+		using iterator_category = std::random_access_iterator_tag;
+
+		ContiguousIterator() = default;
+
+		explicit ContiguousIterator(pointer position) noexcept
+			: mPosition(position)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<typename U, typename = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+		ContiguousIterator(const ContiguousIterator<U>& other) noexcept
+			: mPosition(other.operator->())
+		{
+		}
+
+		// Default Copy/Move Are Fine.
+		// Default Destructor fine.
+
+		reference operator*() const noexcept
+		{
+			return *mPosition;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return mPosition;
+		}
+
+		reference operator[](difference_type n) const noexcept
+		{
+			return mPosition[n];
+		}
+
+		ContiguousIterator& operator++() noexcept
+		{
+			++mPosition;
+			return *this;
+		}
+
+		ContiguousIterator& operator--() noexcept
+		{
+			--mPosition;
+			return *this;
+		}
+
+		// Post increment returns a copy of itself, and THEN increments itself.
+		ContiguousIterator operator++(int) noexcept
+		{
+			ContiguousIterator other(*this);
+			++mPosition;
+			return other;
+		}
+
+		// Post decrement returns a copy of itself, and THEN decrements itself.
+		ContiguousIterator operator--(int) noexcept
+		{
+			ContiguousIterator other(*this);
+			--mPosition;
+			return other;
+		}
+
+		ContiguousIterator& operator+=(difference_type n) noexcept
+		{
+			mPosition += n;
+			return *this;
+		}
+
+		ContiguousIterator& operator-=(difference_type n) noexcept
+		{
+			mPosition -= n;
+			return *this;
+		}
+
+		friend ContiguousIterator operator+(ContiguousIterator it, difference_type n) noexcept
+		{
+			return it += n;
+		}
+
+		friend ContiguousIterator operator+(difference_type n, ContiguousIterator it) noexcept
+		{
+			return it += n;
+		}
+
+		friend ContiguousIterator operator-(ContiguousIterator it, difference_type n) noexcept
+		{
+			return it -= n;
+		}
+
+		friend difference_type operator-(const ContiguousIterator& left, const ContiguousIterator& right) noexcept
+		{
+			return left.mPosition - right.mPosition;
+		}
+
+		// Comparing iterators from different containers is undefined behavior so don't check. Mixed iterator and
+		// const_iterator comparisons go through the implicit conversion.
+		friend bool operator==(const ContiguousIterator& left, const ContiguousIterator& right) noexcept
+		{
+			return left.mPosition == right.mPosition;
+		}
+
+		friend std::strong_ordering operator<=>(const ContiguousIterator& left, const ContiguousIterator& right) noexcept
+		{
+			return std::compare_three_way()(left.mPosition, right.mPosition);
+		}
+
+	private:
+		pointer mPosition = nullptr;
+};
+
+#endif /* INCLUDE_CONTIGUOUSITERATOR_HPP_ */
@@ -0,0 +1,747 @@
+#ifndef INCLUDE_GAPBUFFER_HPP_
+#define INCLUDE_GAPBUFFER_HPP_
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "GrowthPolicy.hpp"
+#include "Relocatable.hpp"
+#include "SimdSearch.hpp"
+
+/**
+ * ArrayList with the spare capacity kept at the last edit position instead of at the end (a gap buffer, the classic
+ * text editor layout). An insert or erase first moves the gap to its position, which shifts only the elements between
+ * the old and the new position, then fills or widens the gap in O(1).
+ *
+ * Access:  O(1) (array lookup, indexes past the gap skip over it)
+ * Insert:  O(d) (d = distance from the previous edit, O(1) amortized for edits clustered around a cursor)
+ * Removal: O(d)
+ * Add:     O(d) (push_front and push_back are O(1) amortized while you keep editing the same end)
+ *
+ * Edits that jump around at random pay O(n) each just like ArrayList. Only the elements themselves are constructed,
+ * the gap is raw memory. Moving the gap relocates elements (see Relocatable.hpp) so T has to be trivially relocatable
+ * or nothrow movable.
+ */
+template<typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class GapBuffer
+{
+	static_assert(detail::is_relocatable_v<T>, "GapBuffer shifts elements by relocation, T needs a nothrow move");
+
+	template<bool Const>
+	class Iterator;
+
+	public:
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = Iterator<false>;
+		using const_iterator         = Iterator<true>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Default constructor. Does not allocate.
+		GapBuffer() noexcept(noexcept(Allocator())) = default;
+
+		explicit GapBuffer(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
+		{
+		}
+
+		GapBuffer(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			reserve(il.size());
+			for(const T& val : il)
+			{
+				push_back(val);
+			}
+		}
+
+		// Copy constructor. The copy is packed with the gap (if any) at the end.
+		GapBuffer(const GapBuffer& other)
+			: mAllocator(AllocTraits::select_on_container_copy_construction(other.mAllocator))
+		{
+			reserve(other.size());
+			for(const T& val : other)
+			{
+				push_back(val);
+			}
+		}
+
+		GapBuffer(GapBuffer&& other) noexcept
+			: mAllocator(std::move(other.mAllocator))
+		{
+			swapStorage(*this, other);
+		}
+
+		// Copy assignment. The copy is built with our own allocator (or other's, if it propagates on copy assignment)
+		// and only replaces the current contents once it's complete.
+		GapBuffer& operator=(const GapBuffer& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(AllocTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!AllocTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			GapBuffer temp(mAllocator);
+			temp.reserve(other.size());
+			for(const T& val : other)
+			{
+				temp.push_back(val);
+			}
+
+			swapStorage(*this, temp);
+			return *this;
+		}
+
+		// Move assignment. Same as ArrayList, an allocator that neither propagates nor compares equal can't take over
+		// the other buffer so the elements are moved over one by one.
+		GapBuffer& operator=(GapBuffer&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+		                                                 AllocTraits::is_always_equal::value)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(AllocTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!AllocTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					reserve(other.size());
+					for(T& val : other)
+					{
+						push_back(std::move(val));
+					}
+
+					other.release();
+					return *this;
+				}
+			}
+
+			swapStorage(*this, other);
+			return *this;
+		}
+
+		virtual ~GapBuffer() noexcept
+		{
+			release();
+		}
+
+		// Like the standard containers, the allocators have to propagate on swap or compare equal
+		friend void swap(GapBuffer& left, GapBuffer& right) noexcept
+		{
+			using std::swap;
+
+			swapStorage(left, right);
+
+			if constexpr(AllocTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return mAllocator;
+		}
+
+		// Iterators:
+		// Invalidated by every insert and erase, the gap moves under them.
+
+		iterator begin() noexcept
+		{
+			return iterator(this, 0);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(this, 0);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(this, size());
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(this, size());
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mMaxSize - gapSize();
+		}
+
+		size_t max_size() const noexcept
+		{
+			return AllocTraits::max_size(mAllocator);
+		}
+
+		size_t capacity() const noexcept
+		{
+			return mMaxSize;
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		// Index the next insert lands at without moving anything (where the gap currently is)
+		size_t gap_position() const noexcept
+		{
+			return mGapStart;
+		}
+
+		void reserve(size_t newCapacity) // throw length_error
+		{
+			if(newCapacity > max_size())
+			{
+				throw std::length_error("Capacity exceeds max_size");
+			}
+
+			if(newCapacity > mMaxSize)
+			{
+				reallocate(newCapacity);
+			}
+		}
+
+		void shrink_to_fit()
+		{
+			if(mMaxSize > size())
+			{
+				reallocate(size());
+			}
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const GapBuffer*>(this)->operator[](index));
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return at(index);
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const GapBuffer*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return mContents[physical(index)];
+		}
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const GapBuffer*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return at(0);
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const GapBuffer*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return at(size() - 1);
+		}
+
+		// Modifiers
+
+		void push_front(const T& val)
+		{
+			emplaceAt(0, val);
+		}
+
+		void push_front(T&& val)
+		{
+			emplaceAt(0, std::move(val));
+		}
+
+		void push_back(const T& val)
+		{
+			emplaceAt(size(), val);
+		}
+
+		void push_back(T&& val)
+		{
+			emplaceAt(size(), std::move(val));
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			return emplaceAt(size(), std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		T& emplace(std::size_t insertIndex, Args&&... args) // throw out_of_range
+		{
+			return emplaceAt(insertIndex, std::forward<Args>(args)...);
+		}
+
+		void insert(const T& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, std::move(val));
+		}
+
+		void replace(const T& val, std::size_t insertIndex) // throw out_of_range
+		{
+			at(insertIndex) = val;
+		}
+
+		void replace(T&& val, std::size_t insertIndex) // throw out_of_range
+		{
+			at(insertIndex) = std::move(val);
+		}
+
+		// Destroy every element. The buffer is kept, use shrink_to_fit() to give it back.
+		void clear() noexcept
+		{
+			destroy(mContents, mContents + mGapStart);
+			destroy(mContents + mGapEnd, mContents + mMaxSize);
+			mGapStart = 0;
+			mGapEnd = mMaxSize;
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(size() - 1);
+		}
+
+		T erase(std::size_t index) // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			// With the gap right before index the element to remove is the first one after the gap, the gap just
+			// swallows its slot
+			moveGap(index);
+			T removed = std::move(mContents[mGapEnd]);
+			AllocTraits::destroy(mAllocator, mContents + mGapEnd);
+			++mGapEnd;
+
+			size_t shrunk = GrowthPolicy::shrink(mMaxSize, size(), sizeof(T));
+			if(shrunk < mMaxSize)
+			{
+				reallocate(shrunk);
+			}
+
+			return removed;
+		}
+
+		void remove(const T& val)
+		{
+			size_t index = find(val);
+			if(index != size())
+			{
+				erase(index);
+			}
+		}
+
+		// Return index of the first element equal to val, or size() if there is none
+		size_t find(const T& val) const
+		{
+			size_t index = findIn(mContents, mGapStart, val);
+			if(index != mGapStart)
+			{
+				return index;
+			}
+
+			return mGapStart + findIn(mContents + mGapEnd, mMaxSize - mGapEnd, val);
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != size();
+		}
+
+	private:
+		using AllocTraits = std::allocator_traits<Allocator>;
+
+		size_t gapSize() const noexcept
+		{
+			return mGapEnd - mGapStart;
+		}
+
+		size_t physical(size_t index) const noexcept
+		{
+			return (index < mGapStart) ? index : index + gapSize();
+		}
+
+		static size_t findIn(const T* contents, size_t count, const T& val)
+		{
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::find(contents, count, val);
+			}
+			else
+			{
+				return static_cast<size_t>(std::find(contents, contents + count, val) - contents);
+			}
+		}
+
+		static void swapStorage(GapBuffer& left, GapBuffer& right) noexcept
+		{
+			std::swap(left.mContents, right.mContents);
+			std::swap(left.mMaxSize, right.mMaxSize);
+			std::swap(left.mGapStart, right.mGapStart);
+			std::swap(left.mGapEnd, right.mGapEnd);
+		}
+
+		void destroy(T* first, T* last) noexcept
+		{
+			for(; first != last; ++first)
+			{
+				AllocTraits::destroy(mAllocator, first);
+			}
+		}
+
+		void release() noexcept
+		{
+			clear();
+			if(mContents != nullptr)
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = nullptr;
+			mMaxSize = 0;
+			mGapStart = 0;
+			mGapEnd = 0;
+		}
+
+		/**
+		 * Slide the elements between the gap and index across it so that the gap starts at index. Only the elements
+		 * in between move.
+		 */
+		void moveGap(size_t index) noexcept
+		{
+			if(index < mGapStart)
+			{
+				size_t count = mGapStart - index;
+				detail::relocate(mAllocator, mContents + index, mContents + mGapStart, mContents + mGapEnd - count);
+				mGapStart -= count;
+				mGapEnd -= count;
+			}
+			else if(index > mGapStart)
+			{
+				size_t count = index - mGapStart;
+				detail::relocate(mAllocator, mContents + mGapEnd, mContents + mGapEnd + count, mContents + mGapStart);
+				mGapStart += count;
+				mGapEnd += count;
+			}
+		}
+
+		// Move to a buffer of maxSize, keeping the gap where it is
+		void reallocate(size_t maxSize)
+		{
+			T* contents = (maxSize == 0) ? nullptr : AllocTraits::allocate(mAllocator, maxSize);
+			size_t tail = mMaxSize - mGapEnd;
+
+			detail::relocate(mAllocator, mContents, mContents + mGapStart, contents);
+			detail::relocate(mAllocator, mContents + mGapEnd, mContents + mMaxSize, contents + maxSize - tail);
+
+			if(mContents != nullptr)
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = contents;
+			mGapEnd = maxSize - tail;
+			mMaxSize = maxSize;
+		}
+
+		template<typename... Args>
+		T& emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			// args could be one of our own elements, build the value before anything moves
+			T temp(std::forward<Args>(args)...);
+
+			if(gapSize() == 0)
+			{
+				reallocate(GrowthPolicy::grow(mMaxSize, mMaxSize + 1, sizeof(T)));
+			}
+
+			moveGap(insertIndex);
+			AllocTraits::construct(mAllocator, mContents + mGapStart, std::move(temp));
+			return mContents[mGapStart++];
+		}
+
+		T*     mContents = nullptr;
+		size_t mMaxSize = 0;
+		size_t mGapStart = 0;
+		size_t mGapEnd = 0;
+		[[no_unique_address]] Allocator mAllocator;
+};
+
+/**
+ * Random access iterator over a GapBuffer. The elements aren't contiguous (the gap sits somewhere in the middle) so
+ * this is an index that gets translated on every dereference.
+ */
+template<typename T, typename Allocator, typename GrowthPolicy>
+template<bool Const>
+class GapBuffer<T, Allocator, GrowthPolicy>::Iterator
+{
+	using List = std::conditional_t<Const, const GapBuffer, GapBuffer>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::random_access_iterator_tag;
+
+		Iterator() = default;
+
+		Iterator(List* list, std::size_t index) noexcept
+			: mList(list), mIndex(index)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mList(other.mList), mIndex(other.mIndex)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return mList->mContents[mList->physical(mIndex)];
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &**this;
+		}
+
+		reference operator[](difference_type offset) const noexcept
+		{
+			return *(*this + offset);
+		}
+
+		Iterator& operator++() noexcept
+		{
+			++mIndex;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++mIndex;
+			return previous;
+		}
+
+		Iterator& operator--() noexcept
+		{
+			--mIndex;
+			return *this;
+		}
+
+		Iterator operator--(int) noexcept
+		{
+			Iterator previous = *this;
+			--mIndex;
+			return previous;
+		}
+
+		Iterator& operator+=(difference_type offset) noexcept
+		{
+			mIndex += static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		Iterator& operator-=(difference_type offset) noexcept
+		{
+			mIndex -= static_cast<std::size_t>(offset);
+			return *this;
+		}
+
+		friend Iterator operator+(Iterator it, difference_type offset) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator+(difference_type offset, Iterator it) noexcept
+		{
+			return it += offset;
+		}
+
+		friend Iterator operator-(Iterator it, difference_type offset) noexcept
+		{
+			return it -= offset;
+		}
+
+		friend difference_type operator-(const Iterator& left, const Iterator& right) noexcept
+		{
+			return static_cast<difference_type>(left.mIndex) - static_cast<difference_type>(right.mIndex);
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex == right.mIndex;
+		}
+
+		friend std::strong_ordering operator<=>(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mIndex <=> right.mIndex;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+
+		List* mList = nullptr;
+		std::size_t mIndex = 0;
+};
+
+// Comparison operators
+
+template<typename T, typename... Policies>
+inline bool operator==(const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename... Policies>
+inline bool operator!=(const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return !operator==(left, right);
+}
+
+template<typename T, typename... Policies>
+inline bool operator< (const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template<typename T, typename... Policies>
+inline bool operator> (const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return operator< (right, left);
+}
+
+template<typename T, typename... Policies>
+inline bool operator<=(const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return !operator> (left, right);
+}
+
+template<typename T, typename... Policies>
+inline bool operator>=(const GapBuffer<T, Policies...>& left, const GapBuffer<T, Policies...>& right)
+{
+	return !operator< (left, right);
+}
+
+#endif /* INCLUDE_GAPBUFFER_HPP_ */
@@ -0,0 +1,146 @@
+#ifndef INCLUDE_GROWTHPOLICY_HPP_
+#define INCLUDE_GROWTHPOLICY_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+/**
+ * Growth policies decide how big the buffer of a contiguous container gets. A policy is a type with two static
+ * functions:
+ *
+ *   size_t grow(size_t capacity, size_t required, size_t elementSize)
+ *     Capacity of the next buffer when capacity can't hold required elements. Must be >= required.
+ *
+ *   size_t shrink(size_t capacity, size_t size, size_t elementSize)
+ *     Capacity to shrink to after an erase, or capacity to keep the current buffer.
+ *
+ * Every shrinking policy leaves a gap between where it grows and where it shrinks (hysteresis). Otherwise alternating
+ * push/pop right at a boundary would reallocate on every call.
+ */
+
+namespace detail
+{
+	static constexpr std::size_t DEFAULT_CAPACITY = 8;
+
+	// Halve once the buffer is down to a quarter full. After halving we're still only half full so it takes a lot of
+	// pushes before we grow again.
+	inline std::size_t shrinkByHalf(std::size_t capacity, std::size_t size) noexcept
+	{
+		if(capacity > DEFAULT_CAPACITY && size < capacity / 4)
+		{
+			return std::max(capacity / 2, DEFAULT_CAPACITY);
+		}
+
+		return capacity;
+	}
+}
+
+// Double the capacity on every growth. Amortized O(1) push_back with the fewest reallocations.
+struct DoublingGrowth
+{
+	static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t) noexcept
+	{
+		return std::max(required, (capacity == 0) ? detail::DEFAULT_CAPACITY : capacity * 2);
+	}
+
+	static std::size_t shrink(std::size_t capacity, std::size_t size, std::size_t) noexcept
+	{
+		return detail::shrinkByHalf(capacity, size);
+	}
+};
+
+// Grow by half again. Wastes less memory and lets the allocator reuse previously freed buffers.
+struct OneAndHalfGrowth
+{
+	static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t) noexcept
+	{
+		return std::max(required, (capacity < detail::DEFAULT_CAPACITY) ? detail::DEFAULT_CAPACITY
+		                                                                 : capacity + capacity / 2);
+	}
+
+	static std::size_t shrink(std::size_t capacity, std::size_t size, std::size_t) noexcept
+	{
+		return detail::shrinkByHalf(capacity, size);
+	}
+};
+
+/**
+ * Double, then round the buffer up to the next malloc size class so the slack the allocator would hand out anyway
+ * becomes usable capacity. Size classes are spaced four to every power of two (16, 20, 24, 28, 32, 40, 48, ...) which
+ * is how glibc, jemalloc and tcmalloc carve up their bins.
+ */
+struct SizeClassGrowth
+{
+	static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t elementSize) noexcept
+	{
+		std::size_t bytes = roundToSizeClass(DoublingGrowth::grow(capacity, required, elementSize) * elementSize);
+		return bytes / elementSize;
+	}
+
+	static std::size_t shrink(std::size_t capacity, std::size_t size, std::size_t elementSize) noexcept
+	{
+		std::size_t shrunk = detail::shrinkByHalf(capacity, size);
+		return (shrunk == capacity) ? capacity : roundToSizeClass(shrunk * elementSize) / elementSize;
+	}
+
+	static std::size_t roundToSizeClass(std::size_t bytes) noexcept
+	{
+		if(bytes <= MIN_CLASS)
+		{
+			return MIN_CLASS;
+		}
+
+		std::size_t step = std::max<std::size_t>(std::bit_floor(bytes - 1) / 4, MIN_CLASS / 4);
+		return (bytes + step - 1) / step * step;
+	}
+
+	static constexpr std::size_t MIN_CLASS = 16;
+};
+
+/**
+ * Grow in fixed steps of Chunk elements. Wastes at most one chunk and is predictable, at the price of O(n) amortized
+ * push_back. Shrinks once two whole chunks are unused.
+ */
+template<std::size_t Chunk = 64>
+struct FixedChunkGrowth
+{
+	static_assert(Chunk > 0, "Chunk must hold at least one element");
+
+	static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t) noexcept
+	{
+		return roundUp(std::max(required, capacity + Chunk));
+	}
+
+	static std::size_t shrink(std::size_t capacity, std::size_t size, std::size_t) noexcept
+	{
+		if(capacity - size > 2 * Chunk)
+		{
+			return roundUp(size + Chunk);
+		}
+
+		return capacity;
+	}
+
+	static std::size_t roundUp(std::size_t count) noexcept
+	{
+		return (count + Chunk - 1) / Chunk * Chunk;
+	}
+};
+
+// Grows like Policy but never gives memory back on erase. Use reserve()/shrink_to_fit() to size the buffer by hand.
+template<typename Policy = DoublingGrowth>
+struct NeverShrink
+{
+	static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t elementSize) noexcept
+	{
+		return Policy::grow(capacity, required, elementSize);
+	}
+
+	static std::size_t shrink(std::size_t capacity, std::size_t, std::size_t) noexcept
+	{
+		return capacity;
+	}
+};
+
+#endif /* INCLUDE_GROWTHPOLICY_HPP_ */
@@ -0,0 +1,758 @@
+#ifndef INCLUDE_INDEXEDSKIPLIST_HPP_
+#define INCLUDE_INDEXEDSKIPLIST_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Skip list where every link also records how many elements it jumps over (its span). Summing spans on the way down
+ * gives the position of every node passed, so positional lookups get the same O(log n) as the ordered ones.
+ *
+ * Access:  O(log n) expected
+ * Insert:  O(log n) expected (at a position, or at its sorted place with insert_sorted())
+ * Removal: O(log n) expected
+ * Search:  O(log n) expected (find() and lower_bound(), only meaningful while the list is sorted by Compare)
+ *
+ * The list can be used purely by position like LinkedList, purely keyed like a sorted multiset, or both: keep it
+ * sorted with insert_sorted() and still read, erase and replace by index. Positional inserts and replace() don't look
+ * at Compare, keeping the order intact is then up to the caller.
+ *
+ * Node heights are random with p = 1/4 per extra level (the same as Redis sorted sets), which averages 1.33 links per
+ * node. A node is one allocation holding the value and exactly as many links as it is tall.
+ */
+template<typename T, typename Compare = std::less<T>, typename Allocator = std::allocator<T>>
+class IndexedSkipList
+{
+	struct Node;
+
+	struct Link
+	{
+		Node*       next = nullptr;
+		std::size_t span = 0;
+	};
+
+	struct Node
+	{
+		template<typename... Args>
+		explicit Node(std::uint8_t height, Args&&... args)
+			: value(std::forward<Args>(args)...), height(height)
+		{
+		}
+
+		Link* links() noexcept
+		{
+			return std::launder(reinterpret_cast<Link*>(reinterpret_cast<unsigned char*>(this) + LINKS_OFFSET));
+		}
+
+		T            value;
+		std::uint8_t height;
+	};
+
+	// The links live right behind the node, in the same allocation
+	static constexpr std::size_t LINKS_OFFSET = (sizeof(Node) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+	struct alignas(std::max(alignof(Node), alignof(Link))) Unit
+	{
+		unsigned char bytes[std::max(alignof(Node), alignof(Link))];
+	};
+
+	using UnitAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Unit>;
+	using UnitTraits    = std::allocator_traits<UnitAllocator>;
+
+	template<bool Const>
+	class Iterator;
+
+	public:
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference       = T&;
+		using const_reference = const T&;
+		using iterator        = Iterator<false>;
+		using const_iterator  = Iterator<true>;
+
+		// Enough for 4^32 elements
+		static constexpr std::size_t MAX_LEVEL = 32;
+
+		IndexedSkipList() = default;
+
+		explicit IndexedSkipList(const Compare& compare, const Allocator& allocator = Allocator())
+			: mCompare(compare), mAllocator(allocator)
+		{
+		}
+
+		IndexedSkipList(const std::initializer_list<T>& il, const Compare& compare = Compare(),
+		                const Allocator& allocator = Allocator())
+			: mCompare(compare), mAllocator(allocator)
+		{
+			for(const T& val : il)
+			{
+				push_back(val);
+			}
+		}
+
+		IndexedSkipList(const IndexedSkipList& other)
+			: mCompare(other.mCompare), mAllocator(UnitTraits::select_on_container_copy_construction(other.mAllocator))
+		{
+			try
+			{
+				for(const T& val : other)
+				{
+					push_back(val);
+				}
+			}
+			catch(...)
+			{
+				clear();
+				throw;
+			}
+		}
+
+		IndexedSkipList(IndexedSkipList&& other) noexcept
+			: mCompare(other.mCompare), mAllocator(std::move(other.mAllocator))
+		{
+			swapNodes(*this, other);
+		}
+
+		// Copy assignment. The copy is built with our own allocator (or other's, if it propagates on copy assignment)
+		// and only replaces the current nodes once it's complete.
+		IndexedSkipList& operator=(const IndexedSkipList& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(UnitTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!UnitTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						clear();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			IndexedSkipList temp(other.mCompare, allocator_type(mAllocator));
+			for(const T& val : other)
+			{
+				temp.push_back(val);
+			}
+
+			swapNodes(*this, temp);
+			std::swap(mCompare, temp.mCompare);
+			return *this;
+		}
+
+		// Move assignment. Nodes belong to the allocator that made them, so when the allocators differ and don't
+		// propagate the elements have to be moved into new nodes one by one.
+		IndexedSkipList& operator=(IndexedSkipList&& other) noexcept(
+			UnitTraits::propagate_on_container_move_assignment::value || UnitTraits::is_always_equal::value)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			clear();
+			mCompare = other.mCompare;
+
+			if constexpr(UnitTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!UnitTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					for(T& val : other)
+					{
+						push_back(std::move(val));
+					}
+
+					other.clear();
+					return *this;
+				}
+			}
+
+			swapNodes(*this, other);
+			return *this;
+		}
+
+		virtual ~IndexedSkipList()
+		{
+			clear();
+		}
+
+		// Like the standard containers, the allocators have to propagate on swap or compare equal
+		friend void swap(IndexedSkipList& left, IndexedSkipList& right) noexcept
+		{
+			using std::swap;
+
+			swapNodes(left, right);
+			swap(left.mCompare, right.mCompare);
+
+			if constexpr(UnitTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return allocator_type(mAllocator);
+		}
+
+		// Iterators: (walk the bottom level)
+
+		iterator begin() noexcept
+		{
+			return iterator(mHead[0].next);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mHead[0].next);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(nullptr);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(nullptr);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mCurrentSize;
+		}
+
+		bool empty() const noexcept
+		{
+			return mCurrentSize == 0;
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return at(index);
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return at(index);
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const IndexedSkipList*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return nodeAt(index)->value;
+		}
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const IndexedSkipList*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mHead[0].next->value;
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const IndexedSkipList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return nodeAt(mCurrentSize - 1)->value;
+		}
+
+		// Modifiers by position
+
+		void push_front(const T& val)
+		{
+			insert(val, 0);
+		}
+
+		void push_front(T&& val)
+		{
+			insert(std::move(val), 0);
+		}
+
+		void push_back(const T& val)
+		{
+			insert(val, mCurrentSize);
+		}
+
+		void push_back(T&& val)
+		{
+			insert(std::move(val), mCurrentSize);
+		}
+
+		void insert(const T& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, std::move(val));
+		}
+
+		template<typename... Args>
+		T& emplace(std::size_t insertIndex, Args&&... args) // throw out_of_range
+		{
+			return emplaceAt(insertIndex, std::forward<Args>(args)...);
+		}
+
+		void replace(const T& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = val;
+		}
+
+		void replace(T&& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = std::move(val);
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(mCurrentSize - 1);
+		}
+
+		T erase(std::size_t index) // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			Path path = pathTo(index);
+			Node* removedNode = path.before[0][0].next;
+
+			T removed = std::move(removedNode->value);
+			unlink(path, removedNode);
+			return removed;
+		}
+
+		void clear() noexcept
+		{
+			Node* node = mHead[0].next;
+			while(node != nullptr)
+			{
+				Node* next = node->links()[0].next;
+				destroyNode(node);
+				node = next;
+			}
+
+			std::fill(std::begin(mHead), std::end(mHead), Link());
+			mLevel = 1;
+			mCurrentSize = 0;
+		}
+
+		// Keyed operations
+		// These assume the list is sorted by Compare.
+
+		/**
+		 * Insert val after any elements equal to it. Returns the index it ended up at.
+		 */
+		size_t insert_sorted(const T& val)
+		{
+			return insertSorted(val);
+		}
+
+		size_t insert_sorted(T&& val)
+		{
+			return insertSorted(std::move(val));
+		}
+
+		// Index of the first element not less than val
+		size_t lower_bound(const T& val) const
+		{
+			return searchPath(val, [this](const T& element, const T& key) { return mCompare(element, key); }).rank[0];
+		}
+
+		// Index of the first element greater than val
+		size_t upper_bound(const T& val) const
+		{
+			return searchPath(val, [this](const T& element, const T& key) { return !mCompare(key, element); }).rank[0];
+		}
+
+		// Index of the first element equal to val, or size() if there is none
+		size_t find(const T& val) const
+		{
+			Path path = searchPath(val, [this](const T& element, const T& key) { return mCompare(element, key); });
+			Node* candidate = path.before[0][0].next;
+			return (candidate != nullptr && !mCompare(val, candidate->value)) ? path.rank[0] : mCurrentSize;
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != mCurrentSize;
+		}
+
+		// Remove the first element equal to val. Returns whether there was one.
+		bool remove(const T& val)
+		{
+			Path path = searchPath(val, [this](const T& element, const T& key) { return mCompare(element, key); });
+			Node* candidate = path.before[0][0].next;
+			if(candidate == nullptr || mCompare(val, candidate->value))
+			{
+				return false;
+			}
+
+			unlink(path, candidate);
+			return true;
+		}
+
+	private:
+		/**
+		 * For every level the links array of the last node before the target position (the head counts as a node at
+		 * position -1) and the number of elements before and including that node.
+		 */
+		struct Path
+		{
+			Link*  before[MAX_LEVEL];
+			size_t rank[MAX_LEVEL];
+		};
+
+		static void swapNodes(IndexedSkipList& left, IndexedSkipList& right) noexcept
+		{
+			std::swap(left.mHead, right.mHead);
+			std::swap(left.mLevel, right.mLevel);
+			std::swap(left.mCurrentSize, right.mCurrentSize);
+			std::swap(left.mRandom, right.mRandom);
+		}
+
+		static constexpr std::size_t unitsFor(std::size_t height) noexcept
+		{
+			return (LINKS_OFFSET + height * sizeof(Link) + sizeof(Unit) - 1) / sizeof(Unit);
+		}
+
+		// 1 + one more level for every pair of zero bits, which is p = 1/4 per level
+		std::uint8_t randomHeight() noexcept
+		{
+			// xorshift64, plenty for coin flips
+			mRandom ^= mRandom << 13;
+			mRandom ^= mRandom >> 7;
+			mRandom ^= mRandom << 17;
+
+			std::size_t height = 1 + static_cast<std::size_t>(std::countr_zero(mRandom | (std::uint64_t(1) << 62))) / 2;
+			return static_cast<std::uint8_t>(std::min(height, MAX_LEVEL));
+		}
+
+		template<typename... Args>
+		Node* createNode(Args&&... args)
+		{
+			std::uint8_t height = randomHeight();
+			Unit* memory = UnitTraits::allocate(mAllocator, unitsFor(height));
+
+			Node* node = reinterpret_cast<Node*>(memory);
+			try
+			{
+				std::construct_at(node, height, std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				UnitTraits::deallocate(mAllocator, memory, unitsFor(height));
+				throw;
+			}
+
+			for(std::size_t i = 0; i < height; ++i)
+			{
+				::new(static_cast<void*>(reinterpret_cast<unsigned char*>(node) + LINKS_OFFSET + i * sizeof(Link))) Link();
+			}
+
+			return node;
+		}
+
+		void destroyNode(Node* node) noexcept
+		{
+			std::size_t height = node->height;
+			std::destroy_at(node);
+			UnitTraits::deallocate(mAllocator, reinterpret_cast<Unit*>(node), unitsFor(height));
+		}
+
+		// Walk down to position index (0 based, so the node found has index elements in front of it)
+		Path pathTo(size_t index) const noexcept
+		{
+			Path path;
+			Link* links = const_cast<Link*>(mHead);
+			size_t traversed = 0;
+
+			for(size_t level = mLevel; level-- > 0;)
+			{
+				while(links[level].next != nullptr && traversed + links[level].span <= index)
+				{
+					traversed += links[level].span;
+					links = links[level].next->links();
+				}
+
+				path.before[level] = links;
+				path.rank[level] = traversed;
+			}
+
+			return path;
+		}
+
+		// Walk down to the first element where goesLeft(element, val) is false
+		template<typename GoesLeft>
+		Path searchPath(const T& val, GoesLeft goesLeft) const
+		{
+			Path path;
+			Link* links = const_cast<Link*>(mHead);
+			size_t traversed = 0;
+
+			for(size_t level = mLevel; level-- > 0;)
+			{
+				while(links[level].next != nullptr && goesLeft(links[level].next->value, val))
+				{
+					traversed += links[level].span;
+					links = links[level].next->links();
+				}
+
+				path.before[level] = links;
+				path.rank[level] = traversed;
+			}
+
+			return path;
+		}
+
+		Node* nodeAt(size_t index) const noexcept
+		{
+			return pathTo(index).before[0][0].next;
+		}
+
+		// Link node in right after the position path leads to
+		void link(Path& path, Node* node) noexcept
+		{
+			size_t height = node->height;
+			if(height > mLevel)
+			{
+				for(size_t level = mLevel; level < height; ++level)
+				{
+					path.before[level] = mHead;
+					path.rank[level] = 0;
+					mHead[level].span = mCurrentSize;
+				}
+
+				mLevel = height;
+			}
+
+			Link* links = node->links();
+			for(size_t level = 0; level < height; ++level)
+			{
+				Link& before = path.before[level][level];
+				// Elements between the level's predecessor and the new node
+				size_t gap = path.rank[0] - path.rank[level];
+
+				links[level].next = before.next;
+				links[level].span = before.span - gap;
+				before.next = node;
+				before.span = gap + 1;
+			}
+
+			// Links above the new node now jump over one more element
+			for(size_t level = height; level < mLevel; ++level)
+			{
+				path.before[level][level].span++;
+			}
+
+			mCurrentSize++;
+		}
+
+		void unlink(Path& path, Node* node) noexcept
+		{
+			Link* links = node->links();
+			for(size_t level = 0; level < mLevel; ++level)
+			{
+				Link& before = path.before[level][level];
+				if(before.next == node)
+				{
+					before.span += links[level].span - 1;
+					before.next = links[level].next;
+				}
+				else
+				{
+					before.span--;
+				}
+			}
+
+			while(mLevel > 1 && mHead[mLevel - 1].next == nullptr)
+			{
+				mLevel--;
+			}
+
+			destroyNode(node);
+			mCurrentSize--;
+		}
+
+		template<typename... Args>
+		T& emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			Node* node = createNode(std::forward<Args>(args)...);
+			Path path = pathTo(insertIndex);
+			link(path, node);
+			return node->value;
+		}
+
+		template<typename Value>
+		size_t insertSorted(Value&& val)
+		{
+			Node* node = createNode(std::forward<Value>(val));
+			Path path = searchPath(node->value, [this](const T& element, const T& key) { return !mCompare(key, element); });
+			link(path, node);
+			return path.rank[0];
+		}
+
+		Link          mHead[MAX_LEVEL];
+		size_t        mLevel = 1;
+		size_t        mCurrentSize = 0;
+		std::uint64_t mRandom = 0x9E3779B97F4A7C15ull;
+		[[no_unique_address]] Compare mCompare;
+		[[no_unique_address]] UnitAllocator mAllocator;
+};
+
+/**
+ * Forward iterator over an IndexedSkipList, follows the bottom level links.
+ */
+template<typename T, typename Compare, typename Allocator>
+template<bool Const>
+class IndexedSkipList<T, Compare, Allocator>::Iterator
+{
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+
+		Iterator() = default;
+
+		explicit Iterator(Node* node) noexcept
+			: mNode(node)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mNode(other.mNode)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return mNode->value;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &mNode->value;
+		}
+
+		Iterator& operator++() noexcept
+		{
+			mNode = mNode->links()[0].next;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mNode == right.mNode;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+
+		Node* mNode = nullptr;
+};
+
+template<typename T, typename Compare, typename Allocator>
+inline bool operator==(const IndexedSkipList<T, Compare, Allocator>& left,
+                       const IndexedSkipList<T, Compare, Allocator>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename Compare, typename Allocator>
+inline bool operator!=(const IndexedSkipList<T, Compare, Allocator>& left,
+                       const IndexedSkipList<T, Compare, Allocator>& right)
+{
+	return !operator==(left, right);
+}
+
+#endif /* INCLUDE_INDEXEDSKIPLIST_HPP_ */
@@ -0,0 +1,74 @@
+#ifndef INCLUDE_INSTRUMENTATION_HPP_
+#define INCLUDE_INSTRUMENTATION_HPP_
+
+#include <cstddef>
+
+/**
+ * Instrumentation policies get told about the expensive things that happen to a container: how it was constructed,
+ * whole-container copies and moves and buffer reallocations. They are per instance, a copied list starts counting
+ * from scratch.
+ *
+ * The default NoInstrumentation is empty and every hook is an inline no-op, so it costs nothing in size or time.
+ * Swap in CountingInstrumentation to find accidental copies:
+ *
+ *   ArrayList<Message, std::allocator<Message>, DoublingGrowth, CountingInstrumentation> messages;
+ *   ...
+ *   if(messages.stats().copies != 0) ...
+ */
+
+struct ContainerStats
+{
+	std::size_t constructions = 0; // Times this instance was constructed (any constructor)
+	std::size_t copies        = 0; // Copy constructions and copy assignments into this instance
+	std::size_t moves         = 0; // Move constructions and move assignments into this instance
+	std::size_t reallocations = 0; // Times the elements were moved to a new buffer
+	std::size_t bytesCopied   = 0; // Element bytes copied in by copies or carried over by reallocations
+};
+
+struct NoInstrumentation
+{
+	void onConstruct() noexcept {}
+	void onCopy(std::size_t) noexcept {}
+	void onMove() noexcept {}
+	void onReallocate(std::size_t) noexcept {}
+
+	ContainerStats stats() const noexcept
+	{
+		return ContainerStats();
+	}
+};
+
+struct CountingInstrumentation
+{
+	void onConstruct() noexcept
+	{
+		++mStats.constructions;
+	}
+
+	void onCopy(std::size_t bytes) noexcept
+	{
+		++mStats.copies;
+		mStats.bytesCopied += bytes;
+	}
+
+	void onMove() noexcept
+	{
+		++mStats.moves;
+	}
+
+	void onReallocate(std::size_t bytes) noexcept
+	{
+		++mStats.reallocations;
+		mStats.bytesCopied += bytes;
+	}
+
+	ContainerStats stats() const noexcept
+	{
+		return mStats;
+	}
+
+	private:
+		ContainerStats mStats;
+};
+
+#endif /* INCLUDE_INSTRUMENTATION_HPP_ */
@@ -0,0 +1,453 @@
+#ifndef INCLUDE_INTRUSIVELIST_HPP_
+#define INCLUDE_INTRUSIVELIST_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Links embedded in an object so it can be put in an IntrusiveList. One hook per list the object can be in at the
+ * same time:
+ *
+ *   struct Connection
+ *   {
+ *       IntrusiveListHook activeHook;
+ *       IntrusiveListHook timeoutHook;
+ *       ...
+ *   };
+ *
+ *   IntrusiveList<Connection, &Connection::activeHook> active;
+ *   IntrusiveList<Connection, &Connection::timeoutHook> timeouts;
+ *
+ * A hook unlinks itself when it is destroyed, so an object that dies while still in a list simply drops out of it.
+ * Copying an object doesn't copy its list membership, the copy starts out unlinked.
+ */
+class IntrusiveListHook
+{
+	public:
+		IntrusiveListHook() noexcept = default;
+
+		IntrusiveListHook(const IntrusiveListHook&) noexcept
+		{
+		}
+
+		IntrusiveListHook& operator=(const IntrusiveListHook&) noexcept
+		{
+			return *this;
+		}
+
+		~IntrusiveListHook()
+		{
+			unlink();
+		}
+
+		bool is_linked() const noexcept
+		{
+			return mNext != nullptr;
+		}
+
+		// Take the object out of whatever list it's in, O(1). Does nothing if it isn't in one.
+		void unlink() noexcept
+		{
+			if(is_linked())
+			{
+				mPrev->mNext = mNext;
+				mNext->mPrev = mPrev;
+				mNext = nullptr;
+				mPrev = nullptr;
+			}
+		}
+
+	private:
+		template<typename T, IntrusiveListHook T::* Hook>
+		friend class IntrusiveList;
+
+		// Link in before position
+		void linkBefore(IntrusiveListHook* position) noexcept
+		{
+			mNext = position;
+			mPrev = position->mPrev;
+			mPrev->mNext = this;
+			position->mPrev = this;
+		}
+
+		IntrusiveListHook* mNext = nullptr;
+		IntrusiveListHook* mPrev = nullptr;
+};
+
+/**
+ * Doubly linked list of objects the list doesn't own. Linking and unlinking just rewires the hook inside the object
+ * (see IntrusiveListHook), nothing is allocated or copied.
+ *
+ * Access:  O(n) (no indexes, walk with the iterators)
+ * Insert:  O(1) (at an iterator, or either end)
+ * Removal: O(1) (given the object or an iterator to it)
+ * Size:    O(n) (objects can unlink themselves without the list knowing, so there's no count to keep)
+ *
+ * The list is circular around a sentinel hook inside the list object, so there are no null checks on the hot paths.
+ * The objects have to outlive their membership, or be destroyed, which unlinks them. Destroying the list unlinks
+ * everything still in it.
+ */
+template<typename T, IntrusiveListHook T::* Hook>
+class IntrusiveList
+{
+	template<bool Const>
+	class Iterator;
+
+	public:
+		using value_type             = T;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = Iterator<false>;
+		using const_iterator         = Iterator<true>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		IntrusiveList() noexcept
+		{
+			reset();
+		}
+
+		// Objects can only be in one list per hook, so there is nothing sensible a copy could do
+		IntrusiveList(const IntrusiveList&) = delete;
+		IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+		IntrusiveList(IntrusiveList&& other) noexcept
+		{
+			reset();
+			take(other);
+		}
+
+		IntrusiveList& operator=(IntrusiveList&& other) noexcept
+		{
+			if(this != &other)
+			{
+				clear();
+				take(other);
+			}
+
+			return *this;
+		}
+
+		~IntrusiveList()
+		{
+			clear();
+			// The sentinel's own destructor must not try to unlink it
+			mSentinel.mNext = nullptr;
+		}
+
+		// Iterators:
+		// Stay valid until the object they point at is unlinked.
+
+		iterator begin() noexcept
+		{
+			return iterator(mSentinel.mNext);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mSentinel.mNext);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(&mSentinel);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(&mSentinel);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		// Iterator to an object that is in this list
+		static iterator iterator_to(T& object) noexcept
+		{
+			return iterator(&(object.*Hook));
+		}
+
+		static const_iterator iterator_to(const T& object) noexcept
+		{
+			return const_iterator(&(object.*Hook));
+		}
+
+		// Capacity:
+
+		bool empty() const noexcept
+		{
+			return mSentinel.mNext == &mSentinel;
+		}
+
+		// Walks the whole list
+		size_t size() const noexcept
+		{
+			return static_cast<size_t>(std::distance(begin(), end()));
+		}
+
+		// Element access:
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const IntrusiveList*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return *begin();
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const IntrusiveList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return *std::prev(end());
+		}
+
+		// Modifiers
+		// Objects that are already in a list through this hook are rejected with invalid_argument.
+
+		void push_front(T& object)
+		{
+			insert(begin(), object);
+		}
+
+		void push_back(T& object)
+		{
+			insert(end(), object);
+		}
+
+		// Link object in before position. Returns an iterator to it.
+		iterator insert(const_iterator position, T& object)
+		{
+			IntrusiveListHook& hook = object.*Hook;
+			if(hook.is_linked())
+			{
+				throw std::invalid_argument("Object is already in a list");
+			}
+
+			hook.linkBefore(const_cast<IntrusiveListHook*>(position.mHook));
+			return iterator(&hook);
+		}
+
+		// Unlink the object at position. Returns an iterator to the one after it.
+		iterator erase(const_iterator position) noexcept
+		{
+			IntrusiveListHook* hook = const_cast<IntrusiveListHook*>(position.mHook);
+			IntrusiveListHook* next = hook->mNext;
+			hook->unlink();
+			return iterator(next);
+		}
+
+		T& pop_front() // throw out_of_range
+		{
+			T& object = front();
+			(object.*Hook).unlink();
+			return object;
+		}
+
+		T& pop_back() // throw out_of_range
+		{
+			T& object = back();
+			(object.*Hook).unlink();
+			return object;
+		}
+
+		// Unlink object from this list. Same as calling unlink() on its hook.
+		static void remove(T& object) noexcept
+		{
+			(object.*Hook).unlink();
+		}
+
+		// Unlink every object. O(n), each hook has to be reset so the objects know they're free.
+		void clear() noexcept
+		{
+			IntrusiveListHook* hook = mSentinel.mNext;
+			while(hook != &mSentinel)
+			{
+				IntrusiveListHook* next = hook->mNext;
+				hook->mNext = nullptr;
+				hook->mPrev = nullptr;
+				hook = next;
+			}
+
+			reset();
+		}
+
+		/**
+		 * Move every object of other to the end of this list. O(1), only the two ends get relinked.
+		 */
+		void splice(IntrusiveList& other) noexcept
+		{
+			if(other.empty() || &other == this)
+			{
+				return;
+			}
+
+			IntrusiveListHook* first = other.mSentinel.mNext;
+			IntrusiveListHook* last = other.mSentinel.mPrev;
+
+			first->mPrev = mSentinel.mPrev;
+			mSentinel.mPrev->mNext = first;
+			last->mNext = &mSentinel;
+			mSentinel.mPrev = last;
+
+			other.reset();
+		}
+
+	private:
+		// From a hook back to the object around it
+		static T& owner(IntrusiveListHook* hook) noexcept
+		{
+			return *reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - hookOffset());
+		}
+
+		static std::ptrdiff_t hookOffset() noexcept
+		{
+			// offsetof doesn't take member pointers, measure it on storage that is never constructed
+			alignas(T) static unsigned char probe[sizeof(T)];
+			T* object = reinterpret_cast<T*>(probe);
+			return reinterpret_cast<char*>(&(object->*Hook)) - reinterpret_cast<char*>(object);
+		}
+
+		void reset() noexcept
+		{
+			mSentinel.mNext = &mSentinel;
+			mSentinel.mPrev = &mSentinel;
+		}
+
+		// Adopt the objects of other. Expects this to be empty.
+		void take(IntrusiveList& other) noexcept
+		{
+			splice(other);
+		}
+
+		IntrusiveListHook mSentinel;
+};
+
+/**
+ * Bidirectional iterator over an IntrusiveList, a pointer to the current hook.
+ */
+template<typename T, IntrusiveListHook T::* Hook>
+template<bool Const>
+class IntrusiveList<T, Hook>::Iterator
+{
+	using HookPointer = std::conditional_t<Const, const IntrusiveListHook*, IntrusiveListHook*>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		Iterator() = default;
+
+		explicit Iterator(HookPointer hook) noexcept
+			: mHook(hook)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mHook(other.mHook)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return owner(const_cast<IntrusiveListHook*>(mHook));
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &**this;
+		}
+
+		Iterator& operator++() noexcept
+		{
+			mHook = mHook->mNext;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			mHook = mHook->mNext;
+			return previous;
+		}
+
+		Iterator& operator--() noexcept
+		{
+			mHook = mHook->mPrev;
+			return *this;
+		}
+
+		Iterator operator--(int) noexcept
+		{
+			Iterator previous = *this;
+			mHook = mHook->mPrev;
+			return previous;
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mHook == right.mHook;
+		}
+
+	private:
+		friend class IntrusiveList;
+
+		template<bool>
+		friend class Iterator;
+
+		HookPointer mHook = nullptr;
+};
+
+#endif /* INCLUDE_INTRUSIVELIST_HPP_ */
@@ -1,51 +1,269 @@
 #ifndef INCLUDE_LINKEDLIST_HPP_
 #define INCLUDE_LINKEDLIST_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <functional>
+#include <limits>
 #include <memory>
-
-template<typename T>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Access:  O(n) (walks from the head, or from whichever end is closer when doubly linked)
+ * Insert:  O(n) (walks to the insert position, the insert itself is O(1))
+ * Removal: O(n) (walks to the element, unlinking is O(1))
+ * Add:     O(1) at either end
+ *
+ * Iterators are forward iterators, bidirectional when doubly linked. Like std::forward_list the list is edited
+ * through the position before the one that changes: insert_after(), erase_after() and splice_after() are O(1) and
+ * before_begin() names the spot in front of the first element.
+ *
+ * The list keeps a tail pointer so back() and push_back() don't walk. pop_back() has to find the new tail, which is
+ * a walk in a singly linked list. Set DoublyLinked (or use DoublyLinkedList) for nodes that also point back at their
+ * predecessor: pop_back() becomes O(1) and the list can be walked from the back, for one more pointer per node.
+ *
+ * Nodes come from Allocator, rebound to the node type. With the default std::allocator every node is its own heap
+ * allocation. For lists that churn through a lot of nodes use SlabAllocator (see SlabAllocator.hpp) which carves the
+ * nodes out of big blocks instead.
+ */
+template<typename T, typename Allocator = std::allocator<T>, bool DoublyLinked = false>
 class LinkedList
 {
+	struct Node;
+
+	// Also the type of before_begin(), so the head is just another "next" to iterators
+	struct SinglyLinks
+	{
+		Node* next = nullptr;
+	};
+
+	struct DoublyLinks : SinglyLinks
+	{
+		Node* prev = nullptr;
+	};
+
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits    = std::allocator_traits<NodeAllocator>;
+
+	// Stand-in for the list pointer singly linked iterators don't need
+	struct NoList
+	{
+		NoList(const LinkedList*) noexcept
+		{
+		}
+	};
+
+	template<bool Const>
+	class Iterator;
+
 	public:
-//		// Default constructor
-//		LinkedList() = default;
-//
-//		// Copy constructor, could just use default
-//		LinkedList(const LinkedList<T>& other)
-//		{
-//			mNode = other.mNode;
-//			mSize = other.mSize;
-//		}
-//
-//		// Move constructor should never throw
-//		LinkedList(LinkedList<T>&& other) noexcept
-//		{
-//			forwardMove(std::forward(other));
-//		}
-//
-//		/**
-//		 * Copy assignment
-//		 */
-//		LinkedList<T>& operator=(LinkedList<T> other)
-//		{
-//			swap(*this, other);
-//			return *this;
-//		}
-//
-//		/**
-//		 * Move assignment should never throw
-//		 */
-//		LinkedList<T>& operator=(LinkedList<T>&& other) noexcept
-//		{
-//			// Don't want to swap. Temporary variable is going away and assigning something to it would be strange
-//			// behavior.
-//			// Also we forward other because && doesn't always mean rvalue reference, it could be a
-//			// forwarding reference (universal reference).
-//			forwardMove(std::forward(other));
-//			return *this;
-//		}
-
-		virtual ~LinkedList() = default;
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = Iterator<false>;
+		using const_iterator         = Iterator<true>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Default constructor
+		LinkedList() = default;
+
+		explicit LinkedList(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
+		{
+		}
+
+		LinkedList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			copyFrom(il.begin(), il.end());
+		}
+
+		// Copy constructor
+		LinkedList(const LinkedList& other)
+			: mAllocator(NodeTraits::select_on_container_copy_construction(other.mAllocator))
+		{
+			copyFrom(other.begin(), other.end());
+		}
+
+		// Move constructor should never throw
+		LinkedList(LinkedList&& other) noexcept
+			: mAllocator(std::move(other.mAllocator))
+		{
+			forwardMove(std::forward<LinkedList>(other));
+		}
+
+		/**
+		 * Copy assignment
+		 * The copy is built from our own allocator, or from other's when that one propagates on copy assignment, and
+		 * then moved in. The allocators are equal by then so the nodes just change hands.
+		 */
+		LinkedList& operator=(const LinkedList& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(NodeTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!NodeTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			LinkedList temp(get_allocator());
+			temp.copyFrom(other.begin(), other.end());
+			*this = std::move(temp);
+			return *this;
+		}
+
+		/**
+		 * Move assignment should never throw
+		 * Nodes belong to the allocator that made them, so when the allocators differ and don't propagate the
+		 * elements have to be moved into new nodes one by one.
+		 */
+		LinkedList& operator=(LinkedList&& other) noexcept(NodeTraits::propagate_on_container_move_assignment::value ||
+		                                                   NodeTraits::is_always_equal::value)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(NodeTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!NodeTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					for(Node* it = other.mFront.next; it != nullptr; it = it->next)
+					{
+						linkAfter(mTail, createNode(std::move(it->data)));
+					}
+
+					other.release();
+					return *this;
+				}
+			}
+
+			forwardMove(std::forward<LinkedList>(other));
+			return *this;
+		}
+
+		virtual ~LinkedList()
+		{
+			release();
+		}
+
+		/**
+		 * Swap function should never throw
+		 */
+		friend void swap(LinkedList& left, LinkedList& right) noexcept
+		{
+			// We always just want to call swap and be done with it. We don't want swap to be a member function. So we
+			// enable ADL (argument dependent lookup) and when we call swap it will find our friend function because
+			// it's a better match
+			using std::swap;
+
+			std::swap(left.mFront.next, right.mFront.next);
+			std::swap(left.mTail, right.mTail);
+			std::swap(left.mCurrentSize, right.mCurrentSize);
+
+			if constexpr(NodeTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return allocator_type(mAllocator);
+		}
+
+		// Iterators:
+
+		iterator before_begin() noexcept
+		{
+			return iterator(&mFront, this);
+		}
+
+		const_iterator before_begin() const noexcept
+		{
+			return const_iterator(const_cast<SinglyLinks*>(&mFront), this);
+		}
+
+		const_iterator cbefore_begin() const noexcept
+		{
+			return before_begin();
+		}
+
+		iterator begin() noexcept
+		{
+			return iterator(mFront.next, this);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mFront.next, this);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(nullptr, this);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(nullptr, this);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept requires DoublyLinked
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept requires DoublyLinked
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept requires DoublyLinked
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept requires DoublyLinked
+		{
+			return const_reverse_iterator(begin());
+		}
 
 		// Capacity:
 		size_t size() const noexcept
@@ -55,7 +273,7 @@ class LinkedList
 
 		size_t max_size() const noexcept
 		{
-			return std::numeric_limits<size_t>::max();
+			return NodeTraits::max_size(mAllocator);
 		}
 
 		bool empty() const noexcept
@@ -67,49 +285,32 @@ class LinkedList
 
 		T& operator[] (size_t index) // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->operator[](index));
+			return const_cast<T&>(static_cast<const LinkedList*>(this)->operator[](index));
 		}
 
 		const T& operator[] (size_t index) const // throw out_of_range
 		{
-			if(index > mCurrentSize)
-			{
-				throw std::out_of_range("Index out of bounds");
-			}
-
-			Node<T>* it = mNode.get();
-			for(std::size_t i = 0; i < index; ++i)
-			{
-				it = it->next.get();
-			}
-
-			return it->data;
+			return at(index);
 		}
 
 		T& at(size_t index) // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->at(index));
+			return const_cast<T&>(static_cast<const LinkedList*>(this)->at(index));
 		}
 
 		const T& at(size_t index) const // throw out_of_range
 		{
-			if(index > mCurrentSize)
+			if(index >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
 
-			Node<T>* it = mNode.get();
-			for(std::size_t i = 0; i < index; ++i)
-			{
-				it = it->next.get();
-			}
-
-			return it->data;
+			return nodeAt(index)->data;
 		}
 
 		T& front()
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->front());
+			return const_cast<T&>(static_cast<const LinkedList*>(this)->front());
 		}
 
 		const T& front() const
@@ -119,12 +320,12 @@ class LinkedList
 				throw std::out_of_range("Empty list");
 			}
 
-			return mNode->data;
+			return mFront.next->data;
 		}
 
 		T& back() // throw out_of_range
 		{
-			return const_cast<T&>(static_cast<const ArrayList<T>*>(this)->back());
+			return const_cast<T&>(static_cast<const LinkedList*>(this)->back());
 		}
 
 		const T& back() const // throw out_of_range
@@ -134,13 +335,7 @@ class LinkedList
 				throw std::out_of_range("Empty list");
 			}
 
-			Node<T>* it = mNode.get();
-			for(std::size_t i = 0; i < mCurrentSize; ++i)
-			{
-				it = it->next();
-			}
-
-			return it->data();
+			return mTail->data;
 		}
 
 		// Modifiers
@@ -152,17 +347,17 @@ class LinkedList
 
 		void push_front (T&& val)
 		{
-			insert(val, 0);
+			insert(std::move(val), 0);
 		}
 
 		void push_back (const T& val)
 		{
-			insert(val, mCurrentSize + 1);
+			insert(val, mCurrentSize);
 		}
 
 		void push_back (T&& val)
 		{
-			insert(val, mCurrentSize + 1);
+			insert(std::move(val), mCurrentSize);
 		}
 
 		T pop_front()
@@ -177,268 +372,747 @@ class LinkedList
 
 		void insert(const T& val, std::size_t insertIndex)
 		{
-			if(insertIndex > mCurrentSize + 1)
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex)
+		{
+			emplaceAt(insertIndex, std::move(val));
+		}
+
+		void replace(const T& val, std::size_t insertIndex)
+		{
+			at(insertIndex) = val;
+		}
+
+		void replace(T&& val, std::size_t insertIndex)
+		{
+			at(insertIndex) = std::move(val);
+		}
+
+		T erase(std::size_t index)
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= mCurrentSize)
 			{
 				throw std::out_of_range("Index out of bounds");
 			}
 
-			if(insertIndex == 0)
+			Node* prev = nullptr;
+			Node* removedNode = nullptr;
+
+			if constexpr(DoublyLinked)
 			{
-				std::unique_ptr<Node> head = std::make_unique<Node>(val);
-				head.next = std::move(mNode);
-				mNode = head;
+				removedNode = nodeAt(index);
+				prev = removedNode->prev;
 			}
 			else
 			{
-				// This seems dirty
-				std::unique_ptr<Node>* it = &mNode;
-				std::unique_ptr<Node>* prev = nullptr;
+				prev = (index == 0) ? nullptr : nodeAt(index - 1);
+				removedNode = linksOf(prev).next;
+			}
 
-				for(std::size_t i = 0; i != insertIndex; ++i)
-				{
-					if(i != 0)
-					{
-						prev = it;
-					}
+			T removed = std::move(removedNode->data);
+			unlink(prev, removedNode);
+			destroyNode(removedNode);
+
+			return removed;
+		}
 
-					it = &(it->next);
+		void remove(const T& val)
+		{
+			size_t index = find(val);
+			if(index != mCurrentSize)
+			{
+				erase(index);
+			}
+		}
+
+		// Return index of element or total size if not found
+		size_t find(const T& val) const
+		{
+			size_t index = 0;
+			for(const Node* it = mFront.next; it != nullptr; it = it->next, ++index)
+			{
+				if(it->data == val)
+				{
+					break;
 				}
+			}
+
+			return index;
+		}
+
+		bool contains(const T& data) const
+		{
+			return find(data) != mCurrentSize;
+		}
+
+		/**
+		 * Destroy every element and give the nodes back to the allocator. O(n) without recursion, or O(blocks) for
+		 * trivially destructible elements on a SlabAllocator of our own.
+		 */
+		void clear() noexcept
+		{
+			release();
+		}
+
+		// Modifiers by iterator
+
+		iterator insert_after(const_iterator pos, const T& val)
+		{
+			return emplace_after(pos, val);
+		}
 
-				std::unique_ptr<Node> newNode = std::make_unique<Node>(val);
-				newNode.next = std::move((*it));
-				prev->next = std::move(newNode);
-
-
-//				Node<T>* it = mNode.get();
-//				Node<T>* prev = nullptr;
-//				for(std::size_t i = 0; i != insertIndex; ++i)
-//				{
-//					if(i != 0)
-//					{
-//						prev = it;
-//					}
-//
-//					it = it->next.get();
-//				}
-//
-//				std::unique_ptr<Node> newNode = std::make_unique<Node>(val);
-//				it
-//				newNode
-//
-//				it->data() = val;
-//				it->next() = nullptr;
+		iterator insert_after(const_iterator pos, T&& val)
+		{
+			return emplace_after(pos, std::move(val));
+		}
+
+		template<typename... Args>
+		iterator emplace_after(const_iterator pos, Args&&... args)
+		{
+			Node* node = createNode(std::forward<Args>(args)...);
+			linkAfter(nodeOf(pos.mLinks), node);
+			return iterator(node, this);
+		}
+
+		// Erase the element after pos. Returns the element that followed it.
+		iterator erase_after(const_iterator pos) noexcept
+		{
+			Node* removedNode = pos.mLinks->next;
+			unlink(nodeOf(pos.mLinks), removedNode);
+			destroyNode(removedNode);
+			return iterator(pos.mLinks->next, this);
+		}
+
+		// Erase (first, last). Returns last.
+		iterator erase_after(const_iterator first, const_iterator last) noexcept
+		{
+			while(first.mLinks->next != last.mLinks)
+			{
+				erase_after(first);
 			}
 
-			mCurrentSize++;
+			return iterator(last.mLinks, this);
 		}
 
-		void insert(T&& val, std::size_t insertIndex)
+		/**
+		 * Splicing moves nodes between lists without copying or allocating anything. Nodes are given back to the
+		 * allocator of the list they end up in, so both lists' allocators have to compare equal.
+		 */
+
+		// Move all of other in after pos. O(1).
+		void splice_after(const_iterator pos, LinkedList& other) noexcept
 		{
-			if(insertIndex > mCurrentSize + 1)
+			if(&other == this || other.empty())
 			{
-				throw std::out_of_range("Index out of bounds");
+				return;
 			}
 
-			if(insertIndex == 0)
+			Node* first = other.mFront.next;
+			Node* last = other.mTail;
+			size_t count = other.mCurrentSize;
+			other.forget();
+
+			linkChainAfter(nodeOf(pos.mLinks), first, last, count);
+		}
+
+		void splice_after(const_iterator pos, LinkedList&& other) noexcept
+		{
+			splice_after(pos, other);
+		}
+
+		// Move the element after it (in other, which may be this list) in after pos. O(1).
+		void splice_after(const_iterator pos, LinkedList& other, const_iterator it) noexcept
+		{
+			Node* node = it.mLinks->next;
+			if(node == nullptr || pos.mLinks == it.mLinks || pos.mLinks == node)
 			{
-				std::unique_ptr<Node> head = std::make_unique<Node>(std::move(val));
-				head.next = std::move(mNode);
-				mNode = head;
+				return;
 			}
-			else
+
+			other.unlink(other.nodeOf(it.mLinks), node);
+			linkAfter(nodeOf(pos.mLinks), node);
+		}
+
+		/**
+		 * Move the elements in (first, last) of other (which may be this list, as long as pos isn't in the range) in
+		 * after pos. Relinking is O(1) but both sizes have to stay exact, so the range is walked once to count it:
+		 * O(k) for k elements.
+		 */
+		void splice_after(const_iterator pos, LinkedList& other, const_iterator first, const_iterator last) noexcept
+		{
+			Node* firstNode = first.mLinks->next;
+			if(static_cast<SinglyLinks*>(firstNode) == last.mLinks)
 			{
-				// This seems dirty
-				std::unique_ptr<Node>* it = &mNode;
-				std::unique_ptr<Node>* prev = nullptr;
+				return;
+			}
 
-				for(std::size_t i = 0; i != insertIndex; ++i)
+			Node* lastNode = firstNode;
+			size_t count = 1;
+			while(static_cast<SinglyLinks*>(lastNode->next) != last.mLinks)
+			{
+				lastNode = lastNode->next;
+				count++;
+			}
+
+			other.unlinkChain(other.nodeOf(first.mLinks), lastNode, count);
+			linkChainAfter(nodeOf(pos.mLinks), firstNode, lastNode, count);
+		}
+
+		/**
+		 * Merge the sorted list other into this sorted list, other ends up empty. Linear, stable (on ties elements
+		 * of this list come first) and relinks nodes instead of copying them. Allocators have to compare equal.
+		 */
+		void merge(LinkedList& other)
+		{
+			merge(other, std::less<>());
+		}
+
+		void merge(LinkedList&& other)
+		{
+			merge(other, std::less<>());
+		}
+
+		template<typename Compare>
+		void merge(LinkedList& other, Compare compare)
+		{
+			if(&other == this || other.empty())
+			{
+				return;
+			}
+
+			Node* right = other.mFront.next;
+			mCurrentSize += other.mCurrentSize;
+			other.forget();
+
+			try
+			{
+				mergeInto(mFront.next, right, compare);
+			}
+			catch(...)
+			{
+				// Every node is still in our chain, just not in order
+				relink();
+				throw;
+			}
+
+			relink();
+		}
+
+		template<typename Compare>
+		void merge(LinkedList&& other, Compare compare)
+		{
+			merge(other, compare);
+		}
+
+		/**
+		 * Stable bottom-up merge sort, O(n log n) and allocates nothing: nodes are relinked, never moved or copied.
+		 * Runs of 2^i nodes are kept in bin i and merged as equally sized runs come along, so the recursion of a
+		 * top-down sort becomes an array of 64 pointers. If compare throws every element is still in the list, in
+		 * no particular order.
+		 */
+		void sort()
+		{
+			sort(std::less<>());
+		}
+
+		template<typename Compare>
+		void sort(Compare compare)
+		{
+			constexpr size_t BIN_COUNT = std::numeric_limits<size_t>::digits;
+
+			Node* bins[BIN_COUNT] = {};
+			size_t binsUsed = 0;
+			Node* carry = nullptr;
+			Node* rest = mFront.next;
+
+			try
+			{
+				while(rest != nullptr)
 				{
-					if(i != 0)
+					carry = rest;
+					rest = rest->next;
+					carry->next = nullptr;
+
+					size_t bin = 0;
+					for(; bin < binsUsed && bins[bin] != nullptr; ++bin)
 					{
-						prev = it;
+						// Older elements sit in the bin, they go on the left to keep the sort stable
+						mergeInto(bins[bin], std::exchange(carry, nullptr), compare);
+						carry = std::exchange(bins[bin], nullptr);
 					}
 
-					it = &(it->next);
+					bins[bin] = std::exchange(carry, nullptr);
+					binsUsed = std::max(binsUsed, bin + 1);
 				}
 
-				std::unique_ptr<Node> newNode = std::make_unique<Node>(std::move(val));
-				newNode.next = std::move((*it));
-				prev->next = std::move(newNode);
+				for(size_t bin = 0; bin < binsUsed; ++bin)
+				{
+					if(bins[bin] != nullptr)
+					{
+						mergeInto(bins[bin], std::exchange(carry, nullptr), compare);
+						carry = std::exchange(bins[bin], nullptr);
+					}
+				}
 			}
+			catch(...)
+			{
+				// Chain whatever is where back together so nothing leaks
+				Node* chains[BIN_COUNT + 2];
+				size_t chainCount = 0;
+				for(Node* chain : bins)
+				{
+					if(chain != nullptr)
+					{
+						chains[chainCount++] = chain;
+					}
+				}
 
-			mCurrentSize++;
-		}
+				for(Node* chain : {carry, rest})
+				{
+					if(chain != nullptr)
+					{
+						chains[chainCount++] = chain;
+					}
+				}
 
-		void replace(const T& val, std::size_t insertIndex)
-		{
-			replace(std::forward(val), insertIndex);
+				mFront.next = nullptr;
+				SinglyLinks* tail = &mFront;
+				for(size_t i = 0; i < chainCount; ++i)
+				{
+					tail->next = chains[i];
+					while(tail->next != nullptr)
+					{
+						tail = tail->next;
+					}
+				}
+
+				relink();
+				throw;
+			}
+
+			mFront.next = carry;
+			relink();
 		}
 
-		void replace(T&& val, std::size_t insertIndex)
+	private:
+		struct Node : std::conditional_t<DoublyLinked, DoublyLinks, SinglyLinks>
 		{
-			if(insertIndex > mCurrentSize)
+			template<typename... Args>
+			explicit Node(Args&&... args)
+				: data(std::forward<Args>(args)...)
 			{
-				throw std::out_of_range("Index out of bounds");
 			}
 
-			// This seems dirty
-			std::unique_ptr<Node>* it = &mNode;
+			T data;
+		};
+
+		// The links holding the pointer to whatever follows prev, the head pointer when prev is nullptr
+		SinglyLinks& linksOf(Node* prev) noexcept
+		{
+			return (prev == nullptr) ? mFront : *prev;
+		}
+
+		// Inverse of linksOf()
+		Node* nodeOf(const SinglyLinks* links) const noexcept
+		{
+			return (links == &mFront) ? nullptr : static_cast<Node*>(const_cast<SinglyLinks*>(links));
+		}
+
+		template<typename... Args>
+		Node* createNode(Args&&... args)
+		{
+			Node* node = NodeTraits::allocate(mAllocator, 1);
 
-			for(std::size_t i = 0; i != insertIndex; ++i)
+			try
 			{
-				it = &(it->next);
+				NodeTraits::construct(mAllocator, node, std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				NodeTraits::deallocate(mAllocator, node, 1);
+				throw;
 			}
 
+			return node;
+		}
 
-//			if(insertIndex > mCurrentSize)
-//			{
-//				throw std::out_of_range("Index out of bounds");
-//			}
-//
-//			Node<T>* it = mNode.get();
-//			for(std::size_t i = 0; i != insertIndex; ++i)
-//			{
-//				it = it->next();
-//			}
-//
-//
-//
-//			mContents[insertIndex] = std::move(val);
+		void destroyNode(Node* node) noexcept
+		{
+			NodeTraits::destroy(mAllocator, node);
+			NodeTraits::deallocate(mAllocator, node, 1);
 		}
 
-		T erase(std::size_t index)
+		// Only called with index < size()
+		Node* nodeAt(size_t index) const noexcept
 		{
-			if(empty())
+			if(index == mCurrentSize - 1)
 			{
-				throw std::out_of_range("Empty list");
+				return mTail;
 			}
 
-			if(index > mCurrentSize)
+			if constexpr(DoublyLinked)
 			{
-				throw std::out_of_range("Index out of bounds");
-			}
+				// Come from the back when that's shorter
+				if(index >= mCurrentSize / 2)
+				{
+					Node* it = mTail;
+					for(std::size_t i = mCurrentSize - 1; i > index; --i)
+					{
+						it = it->prev;
+					}
 
-			// This seems dirty
-			std::unique_ptr<Node>* it = &mNode;
+					return it;
+				}
+			}
 
+			Node* it = mFront.next;
 			for(std::size_t i = 0; i < index; ++i)
 			{
-				it = &(it->next);
+				it = it->next;
 			}
 
-			T removed = (*it)->next->data;
+			return it;
+		}
 
-			// it is prev. it->next is one we want to delete.
-			(*it)->next = (*it)->next->next;
+		// Link node in after prev, or at the head when prev is nullptr
+		void linkAfter(Node* prev, Node* node) noexcept
+		{
+			Node* next = linksOf(prev).next;
+			node->next = next;
+			linksOf(prev).next = node;
 
-			return removed;
+			if constexpr(DoublyLinked)
+			{
+				node->prev = prev;
+				if(next != nullptr)
+				{
+					next->prev = node;
+				}
+			}
+
+			if(next == nullptr)
+			{
+				mTail = node;
+			}
+
+			mCurrentSize++;
 		}
 
-		void remove(const T& val)
+		// Unlink node, which follows prev (nullptr when node is the head). Doesn't destroy it.
+		void unlink(Node* prev, Node* node) noexcept
 		{
-			if( find(val) != mCurrentSize)
+			linksOf(prev).next = node->next;
+
+			if constexpr(DoublyLinked)
 			{
-				erase(val);
+				if(node->next != nullptr)
+				{
+					node->next->prev = prev;
+				}
 			}
+
+			if(node == mTail)
+			{
+				mTail = prev;
+			}
+
+			mCurrentSize--;
 		}
 
-		// Return index of element or total size if not found
-		size_t find(const T& val) const
+		// Link the chain first ... last of count nodes in after prev
+		void linkChainAfter(Node* prev, Node* first, Node* last, size_t count) noexcept
 		{
-			int index = mCurrentSize;
+			Node* next = linksOf(prev).next;
+			linksOf(prev).next = first;
+			last->next = next;
 
-			Node<T>* it = mNode.get();
-			for(std::size_t i = 0; i < mCurrentSize; ++i)
+			if constexpr(DoublyLinked)
 			{
-				if(it->data == val)
+				first->prev = prev;
+				if(next != nullptr)
 				{
-					index = i;
-					break;
+					next->prev = last;
 				}
+			}
 
-				it = it->next.get();
+			if(next == nullptr)
+			{
+				mTail = last;
 			}
 
-			return index;
+			mCurrentSize += count;
 		}
 
-		bool contains(const T& data) const
+		// Unlink the chain of count nodes after prev ending in last. Leaves the chain itself alone.
+		void unlinkChain(Node* prev, Node* last, size_t count) noexcept
 		{
-			bool ret = false;
+			linksOf(prev).next = last->next;
 
-			if(find(data) != mCurrentSize)
+			if constexpr(DoublyLinked)
 			{
-				ret = true;
+				if(last->next != nullptr)
+				{
+					last->next->prev = prev;
+				}
 			}
 
-			return ret;
+			if(last == mTail)
+			{
+				mTail = prev;
+			}
 
+			mCurrentSize -= count;
 		}
 
 		/**
-		 * Swap function should never throw
+		 * Merge the sorted, null terminated chain right into left, stable. If compare throws, left still holds every
+		 * node of both chains.
 		 */
-		friend void swap(LinkedList<T>& left, LinkedList<T>& right) noexcept
+		template<typename Compare>
+		static void mergeInto(Node*& left, Node* right, Compare& compare)
 		{
-			// We always just want to call swap and be done with it. We don't want swap to be a member function. So we
-			// enable ADL (argument dependent lookup) and when we call swap it will find our friend function because
-			// it's a better match
-			using std::swap;
+			SinglyLinks merged;
+			SinglyLinks* tail = &merged;
+			Node* remaining = left;
 
-			std::swap(left.mNode, right.mNode);
-			std::swap(left.mCurrentSize, right.mCurrentSize);
+			try
+			{
+				while(remaining != nullptr && right != nullptr)
+				{
+					if(compare(right->data, remaining->data))
+					{
+						tail->next = right;
+						right = right->next;
+					}
+					else
+					{
+						tail->next = remaining;
+						remaining = remaining->next;
+					}
+
+					tail = tail->next;
+				}
+			}
+			catch(...)
+			{
+				tail->next = remaining;
+				while(tail->next != nullptr)
+				{
+					tail = tail->next;
+				}
+
+				tail->next = right;
+				left = merged.next;
+				throw;
+			}
+
+			tail->next = (remaining != nullptr) ? remaining : right;
+			left = merged.next;
 		}
 
-	private:
-		template<typename T>
-		class Node
+		// Fix the back pointers and the tail after the next pointers have been rearranged
+		void relink() noexcept
 		{
-			public:
-				// Copy constructor
-				explicit Node(const Node<T>& data)
+			Node* prev = nullptr;
+			for(Node* it = mFront.next; it != nullptr; it = it->next)
+			{
+				if constexpr(DoublyLinked)
 				{
-					this->data = data;
-					this->next = nullptr;
+					it->prev = prev;
 				}
 
-//				Node(const T& data, std::shared_ptr<T> next)
-//				{
-//					mData = data;
-//					mNext = next;
-//				}
-
-//				T& data()
-//				{
-//					return mData;
-//				}
-//
-//				Node* next() const
-//				{
-//					return mNext->get();
-//				}
-//
-//				const Node* next() const
-//				{
-//					return mNext->get();
-//				}
-
-				virtual ~Node() = default;
-
-//			private:
-				T data;
-				std::unique_ptr<Node> next = nullptr;
-		};
+				prev = it;
+			}
+
+			mTail = prev;
+		}
+
+		// Drop all nodes without destroying them, they belong to someone else now
+		void forget() noexcept
+		{
+			mFront.next = nullptr;
+			mTail = nullptr;
+			mCurrentSize = 0;
+		}
+
+		template<typename... Args>
+		void emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			Node* prev = (insertIndex == 0) ? nullptr : nodeAt(insertIndex - 1);
+			linkAfter(prev, createNode(std::forward<Args>(args)...));
+		}
+
+		// Appends copies of [first, last). Used by the constructors, cleans up after itself if a copy throws.
+		template<typename It>
+		void copyFrom(It first, It last)
+		{
+			try
+			{
+				for(; first != last; ++first)
+				{
+					linkAfter(mTail, createNode(*first));
+				}
+			}
+			catch(...)
+			{
+				release();
+				throw;
+			}
+		}
+
+		/**
+		 * Destroy every node and leave the list empty. Nodes are freed in a flat loop, so no list is too long to tear
+		 * down. When the nodes have nothing to destroy and the allocator can drop all of its memory at once (a
+		 * SlabAllocator nobody else shares) we skip the walk entirely and free the blocks instead.
+		 */
+		void release() noexcept
+		{
+			bool released = false;
+			if constexpr(std::is_trivially_destructible_v<Node> && requires { mAllocator.try_release(); })
+			{
+				released = (mFront.next != nullptr) && mAllocator.try_release();
+			}
 
-//		void forwardMove(T&& other)
-//		{
-//			mNode = std::move(other.mNode);
-//			mCurrentSize = std::move(other.mCurrentSize);
-//		}
+			Node* it = released ? nullptr : mFront.next;
+			while(it != nullptr)
+			{
+				Node* next = it->next;
+				destroyNode(it);
+				it = next;
+			}
 
-		std::unique_ptr<Node<T>> mNode;
-		size_t mCurrentSize = 0;
+			forget();
+		}
 
+		// Adopts the nodes of other. Expects this to already be empty (or freshly constructed).
+		void forwardMove(LinkedList&& other) noexcept
+		{
+			mFront.next = std::exchange(other.mFront.next, nullptr);
+			mTail = std::exchange(other.mTail, nullptr);
+			mCurrentSize = std::exchange(other.mCurrentSize, 0);
+		}
+
+		SinglyLinks mFront;
+		Node*       mTail = nullptr;
+		size_t      mCurrentSize = 0;
+		[[no_unique_address]] NodeAllocator mAllocator;
 };
 
+/**
+ * Iterator over a LinkedList. Points at the links of a node (or at the list's head pointer for before_begin()), so
+ * the same type can be passed to the *_after() functions. Doubly linked lists also remember the list so end() can
+ * step back to the tail.
+ */
+template<typename T, typename Allocator, bool DoublyLinked>
+template<bool Const>
+class LinkedList<T, Allocator, DoublyLinked>::Iterator
+{
+	// Only doubly linked iterators need to find the tail from end()
+	using ListPointer = std::conditional_t<DoublyLinked, const LinkedList*, NoList>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::conditional_t<DoublyLinked, std::bidirectional_iterator_tag,
+		                                             std::forward_iterator_tag>;
+
+		Iterator() noexcept
+			: mList(nullptr)
+		{
+		}
+
+		Iterator(SinglyLinks* links, const LinkedList* list) noexcept
+			: mLinks(links), mList(list)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mLinks(other.mLinks), mList(other.mList)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return static_cast<Node*>(mLinks)->data;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &static_cast<Node*>(mLinks)->data;
+		}
+
+		Iterator& operator++() noexcept
+		{
+			mLinks = mLinks->next;
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		Iterator& operator--() noexcept requires DoublyLinked
+		{
+			mLinks = (mLinks == nullptr) ? mList->mTail : static_cast<Node*>(mLinks)->prev;
+			return *this;
+		}
+
+		Iterator operator--(int) noexcept requires DoublyLinked
+		{
+			Iterator previous = *this;
+			--*this;
+			return previous;
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mLinks == right.mLinks;
+		}
+
+	private:
+		friend class LinkedList;
+
+		template<bool>
+		friend class Iterator;
+
+		SinglyLinks* mLinks = nullptr;
+		[[no_unique_address]] ListPointer mList;
+};
+
+template<typename T, typename Allocator, bool DoublyLinked>
+inline bool operator==(const LinkedList<T, Allocator, DoublyLinked>& left,
+                       const LinkedList<T, Allocator, DoublyLinked>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename Allocator, bool DoublyLinked>
+inline bool operator!=(const LinkedList<T, Allocator, DoublyLinked>& left,
+                       const LinkedList<T, Allocator, DoublyLinked>& right)
+{
+	return !operator==(left, right);
+}
+
+template<typename T, typename Allocator = std::allocator<T>>
+using DoublyLinkedList = LinkedList<T, Allocator, true>;
 
 #endif /* INCLUDE_LINKEDLIST_HPP_ */
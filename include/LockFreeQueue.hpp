@@ -0,0 +1,426 @@
+#ifndef INCLUDE_LOCKFREEQUEUE_HPP_
+#define INCLUDE_LOCKFREEQUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Multi producer, multi consumer FIFO queue (Michael & Scott). Same node idea as LinkedList, a value plus a next
+ * pointer, but the head and tail are advanced with compare and swap instead of under a lock.
+ *
+ * Push:    O(1) (lock free until the node cache needs the depot, see below)
+ * Pop:     O(1) (lock free until the node cache needs the depot, see below)
+ *
+ * Nodes are reclaimed with hazard pointers: a thread publishes the nodes it's about to dereference, and a popped
+ * node is only reused once no published pointer refers to it. That also rules out ABA on the head and tail.
+ *
+ * Every thread working on the queue borrows a hazard record for the duration of a push or pop. Up to MAX_THREADS
+ * threads can be inside the queue at once. Any more block, spinning until a record comes free. A record also caches
+ * free nodes, so most pushes and pops touch no shared allocator state at all.
+ *
+ * That cache is where the lock freedom ends. A record that runs out of nodes refills from a shared depot in batches,
+ * and one that collects too many hands the surplus back, both under a mutex. When the depot is empty as well the node
+ * comes from Allocator, outside the mutex, so Allocator has to be safe to call from several threads at once. Nodes
+ * are only returned to Allocator when the queue is destroyed.
+ *
+ * The destructor needs every other thread to be done with the queue.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class LockFreeQueue
+{
+	struct Node
+	{
+		std::atomic<Node*> next{nullptr};
+		alignas(T) unsigned char storage[sizeof(T)];
+
+		T* value() noexcept
+		{
+			return std::launder(reinterpret_cast<T*>(storage));
+		}
+	};
+
+	using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+	using NodeTraits    = std::allocator_traits<NodeAllocator>;
+
+	public:
+		using value_type     = T;
+		using allocator_type = Allocator;
+		using size_type      = std::size_t;
+
+		// Threads that can be inside push/pop at the same time
+		static constexpr std::size_t MAX_THREADS = 128;
+
+		LockFreeQueue()
+			: LockFreeQueue(Allocator())
+		{
+		}
+
+		explicit LockFreeQueue(const Allocator& allocator)
+			: mAllocator(allocator), mElementAllocator(allocator)
+		{
+			// Dummy node, the head always points at a node whose value has already been taken
+			Node* dummy = NodeTraits::allocate(mAllocator, 1);
+			NodeTraits::construct(mAllocator, dummy);
+			mHead.store(dummy, std::memory_order_relaxed);
+			mTail.store(dummy, std::memory_order_relaxed);
+		}
+
+		LockFreeQueue(const LockFreeQueue&) = delete;
+		LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+		~LockFreeQueue()
+		{
+			Node* node = mHead.load(std::memory_order_relaxed);
+			Node* next = node->next.load(std::memory_order_relaxed);
+			freeNode(node);
+
+			for(node = next; node != nullptr; node = next)
+			{
+				next = node->next.load(std::memory_order_relaxed);
+				std::allocator_traits<Allocator>::destroy(mElementAllocator, node->value());
+				freeNode(node);
+			}
+
+			for(HazardRecord& record : mRecords)
+			{
+				for(Node* retired : record.retired)
+				{
+					freeNode(retired);
+				}
+
+				freeList(record.freeNodes);
+			}
+
+			freeList(mDepot);
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return mElementAllocator;
+		}
+
+		void push(const T& val)
+		{
+			emplace(val);
+		}
+
+		void push(T&& val)
+		{
+			emplace(std::move(val));
+		}
+
+		template<typename... Args>
+		void emplace(Args&&... args)
+		{
+			RecordGuard guard(*this);
+			HazardRecord& record = guard.record;
+
+			Node* node = takeNode(record);
+			try
+			{
+				std::allocator_traits<Allocator>::construct(mElementAllocator, node->value(), std::forward<Args>(args)...);
+			}
+			catch(...)
+			{
+				recycle(record, node);
+				throw;
+			}
+
+			node->next.store(nullptr, std::memory_order_relaxed);
+
+			while(true)
+			{
+				Node* tail = protect(record.hazards[0], mTail);
+				Node* next = tail->next.load(std::memory_order_acquire);
+
+				if(tail != mTail.load(std::memory_order_acquire))
+				{
+					continue;
+				}
+
+				if(next == nullptr)
+				{
+					Node* expected = nullptr;
+					if(tail->next.compare_exchange_weak(expected, node, std::memory_order_release, std::memory_order_relaxed))
+					{
+						// Swinging the tail may fail, whoever sees it lagging behind will help it along
+						mTail.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+						return;
+					}
+				}
+				else
+				{
+					mTail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Take the value at the front, or nothing if the queue is empty
+		std::optional<T> try_pop()
+		{
+			RecordGuard guard(*this);
+			HazardRecord& record = guard.record;
+
+			while(true)
+			{
+				Node* head = protect(record.hazards[0], mHead);
+				Node* tail = mTail.load(std::memory_order_acquire);
+				Node* next = head->next.load(std::memory_order_acquire);
+				record.hazards[1].store(next);
+
+				// Re-checking the head makes sure next was still in the queue when we published it
+				if(head != mHead.load())
+				{
+					continue;
+				}
+
+				if(next == nullptr)
+				{
+					return std::nullopt;
+				}
+
+				if(head == tail)
+				{
+					// Tail is lagging behind a push that hasn't finished, help it
+					mTail.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+					continue;
+				}
+
+				if(mHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+				{
+					// next is the new dummy. Its value is ours alone now and our hazard keeps the node alive while
+					// we move it out.
+					std::optional<T> value(std::move(*next->value()));
+					std::allocator_traits<Allocator>::destroy(mElementAllocator, next->value());
+					retire(record, head);
+					return value;
+				}
+			}
+		}
+
+		// Snapshot, may be out of date by the time it returns
+		bool empty() const noexcept
+		{
+			Node* head = mHead.load(std::memory_order_acquire);
+			return head->next.load(std::memory_order_acquire) == nullptr && head == mHead.load(std::memory_order_acquire);
+		}
+
+	private:
+		// Retired nodes a thread collects before it checks which of them are safe to reuse
+		static constexpr std::size_t RETIRE_THRESHOLD = 2 * MAX_THREADS;
+
+		// Free nodes a record keeps before handing a batch back to the depot, and the batch size going either way
+		static constexpr std::size_t LOCAL_POOL_LIMIT = 256;
+		static constexpr std::size_t TRANSFER_BATCH = 64;
+
+		struct NodeList
+		{
+			Node*       head = nullptr;
+			std::size_t count = 0;
+
+			void push(Node* node) noexcept
+			{
+				node->next.store(head, std::memory_order_relaxed);
+				head = node;
+				count++;
+			}
+
+			Node* pop() noexcept
+			{
+				Node* node = head;
+				head = node->next.load(std::memory_order_relaxed);
+				count--;
+				return node;
+			}
+		};
+
+		// Owned by one thread at a time, so everything but active and the hazards is plain data
+		struct alignas(64) HazardRecord
+		{
+			std::atomic<bool>  active{false};
+			std::atomic<Node*> hazards[2] = {nullptr, nullptr};
+			std::vector<Node*> retired;
+			NodeList           freeNodes;
+		};
+
+		// Borrows a hazard record for one push or pop
+		struct RecordGuard
+		{
+			explicit RecordGuard(LockFreeQueue& queue)
+				: record(queue.acquireRecord())
+			{
+			}
+
+			RecordGuard(const RecordGuard&) = delete;
+			RecordGuard& operator=(const RecordGuard&) = delete;
+
+			~RecordGuard()
+			{
+				record.hazards[0].store(nullptr, std::memory_order_release);
+				record.hazards[1].store(nullptr, std::memory_order_release);
+				record.active.store(false, std::memory_order_release);
+			}
+
+			HazardRecord& record;
+		};
+
+		HazardRecord& acquireRecord()
+		{
+			// Start where this thread found a free record last time, with few threads that's a hit every time
+			while(true)
+			{
+				for(std::size_t i = 0; i < MAX_THREADS; ++i)
+				{
+					std::size_t index = (tRecordHint + i) % MAX_THREADS;
+					HazardRecord& record = mRecords[index];
+
+					bool expected = false;
+					if(!record.active.load(std::memory_order_relaxed) &&
+					   record.active.compare_exchange_strong(expected, true, std::memory_order_acquire))
+					{
+						tRecordHint = index;
+						return record;
+					}
+				}
+
+				std::this_thread::yield();
+			}
+		}
+
+		// Publish the current value of source in hazard and make sure it was still current after publishing
+		static Node* protect(std::atomic<Node*>& hazard, const std::atomic<Node*>& source) noexcept
+		{
+			Node* node = source.load(std::memory_order_acquire);
+			while(true)
+			{
+				hazard.store(node);
+				Node* again = source.load();
+				if(again == node)
+				{
+					return node;
+				}
+
+				node = again;
+			}
+		}
+
+		void retire(HazardRecord& record, Node* node)
+		{
+			record.retired.push_back(node);
+			if(record.retired.size() >= RETIRE_THRESHOLD)
+			{
+				scan(record);
+			}
+		}
+
+		// Recycle every retired node no thread has published a hazard for
+		void scan(HazardRecord& record)
+		{
+			std::vector<Node*> hazards;
+			hazards.reserve(2 * MAX_THREADS);
+			for(HazardRecord& other : mRecords)
+			{
+				for(std::atomic<Node*>& hazard : other.hazards)
+				{
+					if(Node* node = hazard.load())
+					{
+						hazards.push_back(node);
+					}
+				}
+			}
+
+			std::sort(hazards.begin(), hazards.end(), std::less<Node*>());
+
+			std::vector<Node*> stillHazardous;
+			for(Node* node : record.retired)
+			{
+				if(std::binary_search(hazards.begin(), hazards.end(), node, std::less<Node*>()))
+				{
+					stillHazardous.push_back(node);
+				}
+				else
+				{
+					recycle(record, node);
+				}
+			}
+
+			record.retired.swap(stillHazardous);
+		}
+
+		Node* takeNode(HazardRecord& record)
+		{
+			if(record.freeNodes.count == 0)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mDepotMutex);
+
+					while(record.freeNodes.count < TRANSFER_BATCH && mDepot.count != 0)
+					{
+						record.freeNodes.push(mDepot.pop());
+					}
+				}
+
+				// Nothing to spare anywhere. Allocate after dropping the lock so a slow allocator only stalls us
+				if(record.freeNodes.count == 0)
+				{
+					Node* node = NodeTraits::allocate(mAllocator, 1);
+					NodeTraits::construct(mAllocator, node);
+					return node;
+				}
+			}
+
+			return record.freeNodes.pop();
+		}
+
+		void recycle(HazardRecord& record, Node* node) noexcept
+		{
+			record.freeNodes.push(node);
+
+			if(record.freeNodes.count > LOCAL_POOL_LIMIT)
+			{
+				std::lock_guard<std::mutex> lock(mDepotMutex);
+				for(std::size_t i = 0; i < TRANSFER_BATCH; ++i)
+				{
+					mDepot.push(record.freeNodes.pop());
+				}
+			}
+		}
+
+		void freeNode(Node* node) noexcept
+		{
+			NodeTraits::destroy(mAllocator, node);
+			NodeTraits::deallocate(mAllocator, node, 1);
+		}
+
+		void freeList(NodeList& list) noexcept
+		{
+			while(list.count != 0)
+			{
+				freeNode(list.pop());
+			}
+		}
+
+		alignas(64) std::atomic<Node*> mHead;
+		alignas(64) std::atomic<Node*> mTail;
+
+		HazardRecord mRecords[MAX_THREADS];
+
+		std::mutex mDepotMutex;
+		NodeList   mDepot;
+
+		[[no_unique_address]] NodeAllocator mAllocator;
+		[[no_unique_address]] Allocator mElementAllocator;
+
+		static inline thread_local std::size_t tRecordHint = std::hash<std::thread::id>()(std::this_thread::get_id());
+};
+
+#endif /* INCLUDE_LOCKFREEQUEUE_HPP_ */
@@ -0,0 +1,744 @@
+#ifndef INCLUDE_MMAPARRAYLIST_HPP_
+#define INCLUDE_MMAPARRAYLIST_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ContiguousIterator.hpp"
+#include "GrowthPolicy.hpp"
+#include "SimdSearch.hpp"
+
+/**
+ * How an MmapArrayList maps its file.
+ *
+ * ReadWrite   Shared mapping, created if missing. Changes land in the file (and are seen by every other process that
+ *             maps it), growing extends the file.
+ * ReadOnly    Shared read only mapping. Modifiers throw, writing through data() or an iterator faults.
+ * CopyOnWrite Private mapping of an existing file. The list can be changed and grown freely but the file never is,
+ *             touched pages are copied on first write.
+ */
+enum class MmapMode
+{
+	ReadWrite,
+	ReadOnly,
+	CopyOnWrite
+};
+
+// Access pattern hints, passed on to madvise()
+enum class MmapAdvice
+{
+	Normal,
+	Sequential,
+	Random,
+	WillNeed,
+	DontNeed
+};
+
+/**
+ * ArrayList whose elements live in a memory mapped file instead of on the heap. Opening a list maps the file and is
+ * done, there is nothing to read or deserialize, pages are faulted in as they are touched.
+ *
+ * Access:  O(1) (array lookup)
+ * Insert:  O(n) (memmove of everything after the insert position)
+ * Removal: O(n) (memmove of everything after the removed element)
+ * Add:     O(1) amortized (growing extends the file and remaps, the kernel moves page tables, not data)
+ *
+ * The file starts with a 64 byte header (magic, format version, element size and element count) followed by the raw
+ * elements. Capacity is whatever the rest of the file holds, GrowthPolicy decides how far it grows and the file is
+ * rounded up to whole pages. Elements are stored as their object representation, so T has to be trivially copyable
+ * and a file is only portable between machines with the same layout of T.
+ *
+ * Failing system calls throw std::system_error, files that aren't a list of T throw std::runtime_error.
+ *
+ * A moved from list is unmapped: empty, and only good for being destroyed or assigned to.
+ *
+ * Several processes can map the same file ReadWrite, but the list does no locking. Only one of them may change it and
+ * the others see the changes whenever they land.
+ */
+template<typename T, typename GrowthPolicy = DoublingGrowth>
+class MmapArrayList
+{
+	static_assert(std::is_trivially_copyable_v<T>, "MmapArrayList stores raw bytes, T must be trivially copyable");
+
+	struct Header
+	{
+		char          magic[8];
+		std::uint32_t version;
+		std::uint32_t elementSize;
+		std::uint64_t count;
+	};
+
+	// Keeps the elements aligned for anything up to a cache line
+	static constexpr std::size_t HEADER_SIZE = 64;
+	static constexpr char MAGIC[8] = {'A', 'R', 'R', 'A', 'Y', 'M', 'A', 'P'};
+
+	static_assert(sizeof(Header) <= HEADER_SIZE);
+	static_assert(alignof(T) <= HEADER_SIZE, "Elements are only aligned to the header size");
+
+	public:
+		using value_type             = T;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = ContiguousIterator<T>;
+		using const_iterator         = ContiguousIterator<const T>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		static constexpr std::uint32_t VERSION = 1;
+
+		/**
+		 * Map the list stored in path. In ReadWrite mode a missing or empty file becomes a new, empty list, the
+		 * other modes need an existing list.
+		 */
+		explicit MmapArrayList(const std::string& path, MmapMode mode = MmapMode::ReadWrite)
+			: mMode(mode)
+		{
+			try
+			{
+				open(path);
+			}
+			catch(...)
+			{
+				unmap();
+				throw;
+			}
+		}
+
+		MmapArrayList(const MmapArrayList&) = delete;
+		MmapArrayList& operator=(const MmapArrayList&) = delete;
+
+		MmapArrayList(MmapArrayList&& other) noexcept
+		{
+			swap(*this, other);
+		}
+
+		MmapArrayList& operator=(MmapArrayList&& other) noexcept
+		{
+			MmapArrayList temp = std::move(other);
+			swap(*this, temp);
+			return *this;
+		}
+
+		// Unmaps and closes the file. Nothing is flushed explicitly, the kernel writes back dirty pages of a shared
+		// mapping on its own. Call sync() first when the data has to be on disk.
+		virtual ~MmapArrayList()
+		{
+			unmap();
+		}
+
+		friend void swap(MmapArrayList& left, MmapArrayList& right) noexcept
+		{
+			std::swap(left.mMode, right.mMode);
+			std::swap(left.mFd, right.mFd);
+			std::swap(left.mMapping, right.mMapping);
+			std::swap(left.mMappedBytes, right.mMappedBytes);
+			std::swap(left.mFileBacked, right.mFileBacked);
+		}
+
+		MmapMode mode() const noexcept
+		{
+			return mMode;
+		}
+
+		// Iterators:
+
+		iterator begin() noexcept
+		{
+			return iterator(data());
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(data());
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(data() + size());
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(data() + size());
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return (mMapping == nullptr) ? 0 : static_cast<size_t>(header()->count);
+		}
+
+		size_t capacity() const noexcept
+		{
+			return (mMapping == nullptr) ? 0 : (mMappedBytes - HEADER_SIZE) / sizeof(T);
+		}
+
+		bool empty() const noexcept
+		{
+			return size() == 0;
+		}
+
+		void reserve(size_t newCapacity)
+		{
+			requireWritable();
+			if(newCapacity > capacity())
+			{
+				remap(mappingSize(newCapacity));
+			}
+		}
+
+		/**
+		 * Give the unused capacity back, in ReadWrite mode by truncating the file. Pages of a private mapping are
+		 * simply kept.
+		 */
+		void shrink_to_fit()
+		{
+			requireWritable();
+			size_t bytes = mappingSize(size());
+			if(mFileBacked && mMode == MmapMode::ReadWrite && bytes < mMappedBytes)
+			{
+				remap(bytes);
+			}
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return at(index);
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return at(index);
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const MmapArrayList*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return data()[index];
+		}
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const MmapArrayList*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return data()[0];
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const MmapArrayList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return data()[size() - 1];
+		}
+
+		T* data() noexcept
+		{
+			return const_cast<T*>(static_cast<const MmapArrayList*>(this)->data());
+		}
+
+		const T* data() const noexcept
+		{
+			if(mMapping == nullptr)
+			{
+				return nullptr;
+			}
+
+			return reinterpret_cast<const T*>(static_cast<const unsigned char*>(mMapping) + HEADER_SIZE);
+		}
+
+		std::span<T> span() noexcept
+		{
+			return std::span<T>(data(), size());
+		}
+
+		std::span<const T> span() const noexcept
+		{
+			return std::span<const T>(data(), size());
+		}
+
+		// Modifiers
+
+		void push_back(const T& val)
+		{
+			// val may live in the mapping, which growing can move
+			T copy = val;
+			ensureCapacity(size() + 1);
+			data()[size()] = copy;
+			header()->count++;
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			push_back(T(std::forward<Args>(args)...));
+			return back();
+		}
+
+		void append(std::span<const T> values)
+		{
+			if(values.empty())
+			{
+				return;
+			}
+
+			// Appending part of ourselves: find the source again after growing
+			const T* first = data();
+			bool aliased = values.data() >= first && values.data() < first + capacity();
+			size_t offset = aliased ? static_cast<size_t>(values.data() - first) : 0;
+
+			ensureCapacity(size() + values.size());
+
+			const T* source = aliased ? data() + offset : values.data();
+			std::memmove(static_cast<void*>(data() + size()), source, values.size() * sizeof(T));
+			header()->count += values.size();
+		}
+
+		void insert(const T& val, size_t insertIndex) // throw out_of_range
+		{
+			requireWritable();
+			if(insertIndex > size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			T copy = val;
+			ensureCapacity(size() + 1);
+
+			T* contents = data();
+			std::memmove(static_cast<void*>(contents + insertIndex + 1), contents + insertIndex,
+			             (size() - insertIndex) * sizeof(T));
+			contents[insertIndex] = copy;
+			header()->count++;
+		}
+
+		void replace(const T& val, size_t index) // throw out_of_range
+		{
+			requireWritable();
+			at(index) = val;
+		}
+
+		T erase(size_t index) // throw out_of_range
+		{
+			requireWritable();
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= size())
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			T* contents = data();
+			T removed = contents[index];
+			std::memmove(static_cast<void*>(contents + index), contents + index + 1, (size() - index - 1) * sizeof(T));
+			header()->count--;
+			return removed;
+		}
+
+		T pop_back()
+		{
+			return erase(size() - 1);
+		}
+
+		// New elements are value initialized (zeroed for plain structs)
+		void resize(size_t newSize)
+		{
+			requireWritable();
+			ensureCapacity(newSize);
+
+			for(size_t i = size(); i < newSize; ++i)
+			{
+				data()[i] = T();
+			}
+
+			header()->count = newSize;
+		}
+
+		// Drops the elements but keeps the file at its size, see shrink_to_fit()
+		void clear()
+		{
+			requireWritable();
+			header()->count = 0;
+		}
+
+		// Lookup
+
+		/**
+		 * Return index of the first element equal to val, or size() if there is none. 32/64 bit integers, float and
+		 * double are searched with SIMD (see SimdSearch.hpp).
+		 */
+		size_t find(const T& val) const
+		{
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::find(data(), size(), val);
+			}
+			else
+			{
+				return static_cast<size_t>(std::find(begin(), end(), val) - begin());
+			}
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != size();
+		}
+
+		// Mapping
+
+		/**
+		 * Write dirty pages back to the file and wait for it (msync). Only ReadWrite lists have anything to write.
+		 */
+		void sync()
+		{
+			if(mMode == MmapMode::ReadWrite && ::msync(mMapping, mMappedBytes, MS_SYNC) != 0)
+			{
+				throwSystemError("msync");
+			}
+		}
+
+		/**
+		 * Tell the kernel how the elements are going to be used. Applies to the pages holding [index, index + count)
+		 * or to the whole mapping. DontNeed drops pages: fine for shared mappings, they come back from the file, but
+		 * on a CopyOnWrite list it throws away changes made to them.
+		 */
+		void advise(MmapAdvice advice)
+		{
+			adviseBytes(advice, 0, mMappedBytes);
+		}
+
+		void advise(MmapAdvice advice, size_t index, size_t count) // throw out_of_range
+		{
+			if(index > size() || count > size() - index)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			adviseBytes(advice, HEADER_SIZE + index * sizeof(T), count * sizeof(T));
+		}
+
+	private:
+		static size_t pageSize() noexcept
+		{
+			static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			return page;
+		}
+
+		// Whole pages holding the header and capacity elements
+		static size_t mappingSize(size_t capacity) noexcept
+		{
+			size_t bytes = HEADER_SIZE + capacity * sizeof(T);
+			return (bytes + pageSize() - 1) / pageSize() * pageSize();
+		}
+
+		[[noreturn]] static void throwSystemError(const std::string& what)
+		{
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		Header* header() noexcept
+		{
+			return static_cast<Header*>(mMapping);
+		}
+
+		const Header* header() const noexcept
+		{
+			return static_cast<const Header*>(mMapping);
+		}
+
+		void requireWritable() const
+		{
+			if(mMode == MmapMode::ReadOnly)
+			{
+				throw std::logic_error("List is read-only");
+			}
+		}
+
+		void open(const std::string& path)
+		{
+			int flags = (mMode == MmapMode::ReadWrite) ? O_RDWR | O_CREAT : O_RDONLY;
+			mFd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+			if(mFd < 0)
+			{
+				throwSystemError("open " + path);
+			}
+
+			struct stat status;
+			if(::fstat(mFd, &status) != 0)
+			{
+				throwSystemError("fstat " + path);
+			}
+
+			size_t bytes = static_cast<size_t>(status.st_size);
+			bool created = (bytes == 0 && mMode == MmapMode::ReadWrite);
+			if(created)
+			{
+				bytes = mappingSize(GrowthPolicy::grow(0, 1, sizeof(T)));
+				if(::ftruncate(mFd, static_cast<off_t>(bytes)) != 0)
+				{
+					throwSystemError("ftruncate " + path);
+				}
+			}
+
+			if(bytes < HEADER_SIZE)
+			{
+				throw std::runtime_error(path + " is not an MmapArrayList file");
+			}
+
+			int protection = (mMode == MmapMode::ReadOnly) ? PROT_READ : PROT_READ | PROT_WRITE;
+			int sharing = (mMode == MmapMode::CopyOnWrite) ? MAP_PRIVATE : MAP_SHARED;
+			void* mapping = ::mmap(nullptr, bytes, protection, sharing, mFd, 0);
+			if(mapping == MAP_FAILED)
+			{
+				throwSystemError("mmap " + path);
+			}
+
+			mMapping = mapping;
+			mMappedBytes = bytes;
+
+			if(created)
+			{
+				Header* fresh = header();
+				std::memcpy(fresh->magic, MAGIC, sizeof(MAGIC));
+				fresh->version = VERSION;
+				fresh->elementSize = sizeof(T);
+				fresh->count = 0;
+				return;
+			}
+
+			const Header* existing = header();
+			if(std::memcmp(existing->magic, MAGIC, sizeof(MAGIC)) != 0)
+			{
+				throw std::runtime_error(path + " is not an MmapArrayList file");
+			}
+
+			if(existing->version != VERSION)
+			{
+				throw std::runtime_error(path + " has unsupported format version " + std::to_string(existing->version));
+			}
+
+			if(existing->elementSize != sizeof(T))
+			{
+				throw std::runtime_error(path + " holds elements of " + std::to_string(existing->elementSize) +
+				                         " bytes, expected " + std::to_string(sizeof(T)));
+			}
+
+			if(existing->count > capacity())
+			{
+				throw std::runtime_error(path + " is truncated");
+			}
+		}
+
+		void unmap() noexcept
+		{
+			if(mMapping != nullptr)
+			{
+				::munmap(mMapping, mMappedBytes);
+				mMapping = nullptr;
+				mMappedBytes = 0;
+			}
+
+			if(mFd >= 0)
+			{
+				::close(mFd);
+				mFd = -1;
+			}
+		}
+
+		void ensureCapacity(size_t required)
+		{
+			requireWritable();
+			if(required > capacity())
+			{
+				remap(mappingSize(GrowthPolicy::grow(capacity(), required, sizeof(T))));
+			}
+		}
+
+		/**
+		 * Resize the mapping to bytes. A ReadWrite list resizes its file and remaps it, mremap() can usually just
+		 * extend the mapping in place or move the page tables. A CopyOnWrite list can't touch its file, so the first
+		 * time it grows its contents are copied into anonymous memory, which from then on is remapped the same way.
+		 */
+		void remap(size_t bytes)
+		{
+			if(mFileBacked && mMode == MmapMode::ReadWrite)
+			{
+				if(::ftruncate(mFd, static_cast<off_t>(bytes)) != 0)
+				{
+					throwSystemError("ftruncate");
+				}
+
+				resizeMapping(bytes, MAP_SHARED, mFd);
+				return;
+			}
+
+			if(mFileBacked)
+			{
+				void* anonymous = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if(anonymous == MAP_FAILED)
+				{
+					throwSystemError("mmap");
+				}
+
+				std::memcpy(anonymous, mMapping, std::min(bytes, mMappedBytes));
+				::munmap(mMapping, mMappedBytes);
+				mMapping = anonymous;
+				mMappedBytes = bytes;
+				mFileBacked = false;
+				return;
+			}
+
+			resizeMapping(bytes, MAP_PRIVATE | MAP_ANONYMOUS, -1);
+		}
+
+		void resizeMapping(size_t bytes, [[maybe_unused]] int flags, [[maybe_unused]] int fd)
+		{
+#ifdef MREMAP_MAYMOVE
+			void* mapping = ::mremap(mMapping, mMappedBytes, bytes, MREMAP_MAYMOVE);
+			if(mapping == MAP_FAILED)
+			{
+				throwSystemError("mremap");
+			}
+#else
+			// No mremap() outside Linux: map the new size, carry anonymous contents over by hand
+			void* mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, fd, 0);
+			if(mapping == MAP_FAILED)
+			{
+				throwSystemError("mmap");
+			}
+
+			if(fd < 0)
+			{
+				std::memcpy(mapping, mMapping, std::min(bytes, mMappedBytes));
+			}
+
+			::munmap(mMapping, mMappedBytes);
+#endif
+			mMapping = mapping;
+			mMappedBytes = bytes;
+		}
+
+		void adviseBytes(MmapAdvice advice, size_t offset, size_t length)
+		{
+			if(length == 0)
+			{
+				return;
+			}
+
+			// madvise wants a page aligned start
+			size_t start = offset / pageSize() * pageSize();
+			length += offset - start;
+
+			int flag = MADV_NORMAL;
+			switch(advice)
+			{
+				case MmapAdvice::Normal:     flag = MADV_NORMAL;     break;
+				case MmapAdvice::Sequential: flag = MADV_SEQUENTIAL; break;
+				case MmapAdvice::Random:     flag = MADV_RANDOM;     break;
+				case MmapAdvice::WillNeed:   flag = MADV_WILLNEED;   break;
+				case MmapAdvice::DontNeed:   flag = MADV_DONTNEED;   break;
+			}
+
+			if(::madvise(static_cast<unsigned char*>(mMapping) + start, length, flag) != 0)
+			{
+				throwSystemError("madvise");
+			}
+		}
+
+		MmapMode mMode = MmapMode::ReadWrite;
+		int      mFd = -1;
+		void*    mMapping = nullptr;
+		size_t   mMappedBytes = 0;
+		// False once a CopyOnWrite list has moved to anonymous memory
+		bool     mFileBacked = true;
+};
+
+template<typename T, typename GrowthPolicy>
+inline bool operator==(const MmapArrayList<T, GrowthPolicy>& left, const MmapArrayList<T, GrowthPolicy>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename GrowthPolicy>
+inline bool operator!=(const MmapArrayList<T, GrowthPolicy>& left, const MmapArrayList<T, GrowthPolicy>& right)
+{
+	return !operator==(left, right);
+}
+
+#endif /* INCLUDE_MMAPARRAYLIST_HPP_ */
@@ -0,0 +1,212 @@
+#ifndef INCLUDE_PARALLELALGORITHMS_HPP_
+#define INCLUDE_PARALLELALGORITHMS_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+#include "ArrayList.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Parallel versions of the usual scans over anything with a contiguous buffer (ArrayList, SmallArrayList,
+ * std::vector, ...).
+ *
+ * The buffer is cut into chunks that run as tasks on a WorkStealingPool, WorkStealingPool::instance() unless one is
+ * passed in. Small inputs don't pay for any of it and just run on the calling thread.
+ *
+ * Functions passed in run concurrently on different elements, so they must not touch shared state without
+ * synchronisation. reduce() combines chunk results in order, op only has to be associative.
+ */
+namespace parallel
+{
+	namespace detail
+	{
+		// Less than this many bytes per chunk and the task overhead outweighs the work
+		constexpr std::size_t MIN_CHUNK_BYTES = 32 * 1024;
+
+		// Chunks per worker, more gives stealing something to even out uneven work with
+		constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+		/**
+		 * Elements per chunk for n elements of type T. Grows with the input so that there are about
+		 * CHUNKS_PER_THREAD chunks for every worker, but never gets below MIN_CHUNK_BYTES worth of elements.
+		 */
+		template<typename T>
+		std::size_t grainSize(std::size_t n, std::size_t threads) noexcept
+		{
+			std::size_t minGrain = std::max<std::size_t>(MIN_CHUNK_BYTES / sizeof(T), 1);
+			std::size_t chunks = threads * CHUNKS_PER_THREAD;
+			return std::max(minGrain, (n + chunks - 1) / chunks);
+		}
+
+		/**
+		 * Call body(first, last) for every chunk of [0, n). The last chunk runs on the calling thread, which then
+		 * helps with the rest until all of them are done.
+		 */
+		template<typename T, typename Body>
+		void forEachChunk(std::size_t n, WorkStealingPool& pool, Body body)
+		{
+			std::size_t grain = grainSize<T>(n, pool.size());
+			if(n <= grain)
+			{
+				body(std::size_t(0), n);
+				return;
+			}
+
+			TaskGroup group(pool);
+			std::size_t first = 0;
+			for(; first + grain < n; first += grain)
+			{
+				group.run([&body, first, grain] { body(first, first + grain); });
+			}
+
+			body(first, n);
+			group.wait();
+		}
+
+		template<typename Range>
+		using element_t = std::remove_reference_t<std::ranges::range_reference_t<Range>>;
+	}
+
+	// Call function(element) for every element
+	template<std::ranges::contiguous_range Range, typename Function>
+	void for_each(Range&& range, Function function, WorkStealingPool& pool = WorkStealingPool::instance())
+	{
+		auto* data = std::ranges::data(range);
+		detail::forEachChunk<detail::element_t<Range>>(std::ranges::size(range), pool,
+			[data, &function](std::size_t first, std::size_t last)
+			{
+				std::for_each(data + first, data + last, function);
+			});
+	}
+
+	/**
+	 * out[i] = function(range[i]) for every element. out has to be a random access iterator with room for size()
+	 * elements, the same as for std::transform. out may be range.begin() to transform in place.
+	 */
+	template<std::ranges::contiguous_range Range, std::random_access_iterator OutIt, typename Function>
+	OutIt transform(Range&& range, OutIt out, Function function, WorkStealingPool& pool = WorkStealingPool::instance())
+	{
+		auto* data = std::ranges::data(range);
+		std::size_t n = std::ranges::size(range);
+
+		detail::forEachChunk<detail::element_t<Range>>(n, pool,
+			[data, out, &function](std::size_t first, std::size_t last)
+			{
+				std::transform(data + first, data + last, out + static_cast<std::ptrdiff_t>(first), function);
+			});
+
+		return out + static_cast<std::ptrdiff_t>(n);
+	}
+
+	/**
+	 * Fold every element into init with op. Each chunk is folded separately (starting from its first element, so init
+	 * only gets used once) and the chunk results are folded in order, which gives the same answer as a sequential
+	 * std::accumulate for any associative op.
+	 */
+	template<std::ranges::contiguous_range Range, typename Value, typename BinaryOp = std::plus<>>
+	Value reduce(Range&& range, Value init, BinaryOp op = BinaryOp(), WorkStealingPool& pool = WorkStealingPool::instance())
+	{
+		using T = detail::element_t<Range>;
+
+		auto* data = std::ranges::data(range);
+		std::size_t n = std::ranges::size(range);
+		if(n == 0)
+		{
+			return init;
+		}
+
+		std::size_t grain = detail::grainSize<T>(n, pool.size());
+		ArrayList<Value> partials;
+		partials.reserve((n + grain - 1) / grain);
+		for(std::size_t first = 0; first < n; first += grain)
+		{
+			partials.emplace_back(data[first]);
+		}
+
+		Value* results = partials.data();
+		detail::forEachChunk<T>(n, pool, [data, results, grain, &op](std::size_t first, std::size_t last)
+		{
+			// forEachChunk uses the same grain, so first / grain is this chunk's slot
+			Value& result = results[first / grain];
+			for(std::size_t i = first + 1; i < last; ++i)
+			{
+				result = op(std::move(result), data[i]);
+			}
+		});
+
+		for(Value& partial : partials)
+		{
+			init = op(std::move(init), std::move(partial));
+		}
+
+		return init;
+	}
+
+	// Number of elements that satisfy predicate
+	template<std::ranges::contiguous_range Range, typename Predicate>
+	std::size_t count_if(Range&& range, Predicate predicate, WorkStealingPool& pool = WorkStealingPool::instance())
+	{
+		auto* data = std::ranges::data(range);
+		std::atomic<std::size_t> total{0};
+
+		detail::forEachChunk<detail::element_t<Range>>(std::ranges::size(range), pool,
+			[data, &predicate, &total](std::size_t first, std::size_t last)
+			{
+				std::size_t found = static_cast<std::size_t>(std::count_if(data + first, data + last, predicate));
+				total.fetch_add(found, std::memory_order_relaxed);
+			});
+
+		return total.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Index of the first element that satisfies predicate, or size() if none does. Same as the sequential find_if
+	 * even if several chunks find a match: the smallest index wins. Chunks that start after a match that was already
+	 * found are skipped, and a running scan gives up once an earlier match turns up.
+	 */
+	template<std::ranges::contiguous_range Range, typename Predicate>
+	std::size_t find_if(Range&& range, Predicate predicate, WorkStealingPool& pool = WorkStealingPool::instance())
+	{
+		// How often a scan looks at whether an earlier chunk already found something
+		constexpr std::size_t CHECK_INTERVAL = 1024;
+
+		auto* data = std::ranges::data(range);
+		std::size_t n = std::ranges::size(range);
+		std::atomic<std::size_t> best{n};
+
+		detail::forEachChunk<detail::element_t<Range>>(n, pool,
+			[data, &predicate, &best](std::size_t first, std::size_t last)
+			{
+				for(std::size_t block = first; block < last; block += CHECK_INTERVAL)
+				{
+					if(block >= best.load(std::memory_order_relaxed))
+					{
+						return;
+					}
+
+					std::size_t blockEnd = std::min(block + CHECK_INTERVAL, last);
+					auto found = std::find_if(data + block, data + blockEnd, predicate);
+					if(found != data + blockEnd)
+					{
+						std::size_t index = static_cast<std::size_t>(found - data);
+						std::size_t current = best.load(std::memory_order_relaxed);
+						while(index < current && !best.compare_exchange_weak(current, index, std::memory_order_relaxed))
+						{
+						}
+
+						return;
+					}
+				}
+			});
+
+		return best.load(std::memory_order_relaxed);
+	}
+}
+
+#endif /* INCLUDE_PARALLELALGORITHMS_HPP_ */
@@ -0,0 +1,84 @@
+#ifndef INCLUDE_RELOCATABLE_HPP_
+#define INCLUDE_RELOCATABLE_HPP_
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * A type is trivially relocatable when moving an object to a new address and destroying the old one is the same as
+ * copying its bytes over. Every trivially copyable type qualifies. Most other types do as well (std::unique_ptr,
+ * std::vector, anything that doesn't point into itself or register its own address somewhere) but the compiler has
+ * no way of knowing that, so it's opt-in:
+ *
+ *   template<>
+ *   struct is_trivially_relocatable<MyType> : std::true_type {};
+ */
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail
+{
+	/**
+	 * Types we can shift around by relocating. Anything else has a move constructor that might throw and has to be
+	 * shifted by assignment so that a failure part way through still leaves every slot holding an object.
+	 */
+	template<typename T>
+	inline constexpr bool is_relocatable_v = is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>;
+
+	/**
+	 * Relocate [first, last) to dest. The ranges may overlap. Afterwards the objects live at dest and whatever part
+	 * of the source isn't covered by the destination is raw memory.
+	 *
+	 * Trivially relocatable types are moved with a single memmove, everything else is move constructed into place
+	 * and the source destroyed one element at a time.
+	 */
+	template<typename Allocator, typename T>
+	void relocate(Allocator& allocator, T* first, T* last, T* dest) noexcept
+	{
+		static_assert(is_relocatable_v<T>, "relocate needs a trivially relocatable or nothrow movable type");
+
+		if(first == last || first == dest)
+		{
+			return;
+		}
+
+		if constexpr(is_trivially_relocatable_v<T>)
+		{
+			std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+			             static_cast<std::size_t>(last - first) * sizeof(T));
+		}
+		else
+		{
+			using Traits = std::allocator_traits<Allocator>;
+
+			// Walk away from the overlap so we never construct on top of a source element we haven't moved yet.
+			if(dest < first)
+			{
+				for(; first != last; ++first, ++dest)
+				{
+					Traits::construct(allocator, dest, std::move(*first));
+					Traits::destroy(allocator, first);
+				}
+			}
+			else
+			{
+				dest += (last - first);
+				while(last != first)
+				{
+					--last;
+					--dest;
+					Traits::construct(allocator, dest, std::move(*last));
+					Traits::destroy(allocator, last);
+				}
+			}
+		}
+	}
+}
+
+#endif /* INCLUDE_RELOCATABLE_HPP_ */
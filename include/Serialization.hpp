@@ -0,0 +1,478 @@
+#ifndef INCLUDE_SERIALIZATION_HPP_
+#define INCLUDE_SERIALIZATION_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "ArrayList.hpp"
+#include "LinkedList.hpp"
+
+/**
+ * Binary snapshots of ArrayList and LinkedList, written to and read from a POSIX file descriptor (file, pipe or
+ * socket alike).
+ *
+ * A snapshot is a 40 byte header followed by the elements as raw bytes:
+ *
+ *   magic        8 bytes  "LISTSNAP"
+ *   version      2 bytes  FORMAT_VERSION
+ *   endianness   1 byte   1 little, 2 big
+ *   (reserved)   1 byte
+ *   element size 4 bytes  sizeof(T)
+ *   count        8 bytes  number of elements
+ *   checksum     8 bytes  Fletcher-64 of the element bytes
+ *   (reserved)   8 bytes
+ *
+ * Header fields are in the byte order of the writer. Elements are stored as their object representation, so only
+ * trivially copyable types can be saved, and a snapshot only loads on a machine with the same byte order and the
+ * same layout of T. Loading checks all of that and throws std::runtime_error on a mismatch, on a short file and on a
+ * bad checksum. Failing system calls throw std::system_error.
+ *
+ * An ArrayList goes out with a single writev() of header and buffer. A LinkedList is walked twice, once for the
+ * checksum the header needs and once to copy the elements into chunk sized writes. Loading reads a chunk at a time and
+ * appends it to the new list. When loading an ArrayList from a regular file the count is checked against the size of
+ * the file first and the list reserved for all of it, so there is exactly one allocation. From a pipe or socket the
+ * count can't be checked before the data shows up, so only one chunk is reserved and the list grows from there. The
+ * target list is only replaced once the whole snapshot has been read and checked.
+ */
+namespace serialization
+{
+	static constexpr std::uint16_t FORMAT_VERSION = 1;
+
+	// Size of the buffer chunked reads and LinkedList writes go through
+	static constexpr std::size_t CHUNK_BYTES = 64 * 1024;
+
+	/**
+	 * Fletcher-64 over 32 bit words in native byte order, the tail padded with zeros. The sums are only reduced every
+	 * REDUCE_INTERVAL words, which keeps the loop down to two adds per word. Can be fed in pieces of any size.
+	 */
+	class Checksum
+	{
+		public:
+			void update(const void* data, std::size_t bytes) noexcept
+			{
+				const unsigned char* input = static_cast<const unsigned char*>(data);
+
+				// Finish a word left over from the previous piece
+				while(mPendingBytes != 0 && bytes != 0)
+				{
+					mPending[mPendingBytes++] = *input++;
+					bytes--;
+
+					if(mPendingBytes == sizeof(std::uint32_t))
+					{
+						addWord(loadWord(mPending));
+						mPendingBytes = 0;
+					}
+				}
+
+				if(bytes == 0)
+				{
+					return;
+				}
+
+				for(; bytes >= sizeof(std::uint32_t); bytes -= sizeof(std::uint32_t), input += sizeof(std::uint32_t))
+				{
+					addWord(loadWord(input));
+				}
+
+				// Keep the tail for the next piece
+				for(std::size_t i = 0; i < bytes; ++i)
+				{
+					mPending[i] = input[i];
+				}
+
+				mPendingBytes = bytes;
+			}
+
+			std::uint64_t value() const noexcept
+			{
+				Checksum final = *this;
+				if(final.mPendingBytes != 0)
+				{
+					std::memset(final.mPending + final.mPendingBytes, 0, sizeof(std::uint32_t) - final.mPendingBytes);
+					final.addWord(loadWord(final.mPending));
+				}
+
+				final.reduce();
+				return (final.mHigh << 32) | final.mLow;
+			}
+
+		private:
+			static constexpr std::uint64_t MODULUS = 0xFFFFFFFF;
+
+			// High sum stays below 2^64 for this many words between reductions
+			static constexpr std::size_t REDUCE_INTERVAL = 65536;
+
+			static std::uint32_t loadWord(const unsigned char* bytes) noexcept
+			{
+				std::uint32_t word;
+				std::memcpy(&word, bytes, sizeof(word));
+				return word;
+			}
+
+			void addWord(std::uint32_t word) noexcept
+			{
+				mLow += word;
+				mHigh += mLow;
+
+				if(++mWords == REDUCE_INTERVAL)
+				{
+					reduce();
+				}
+			}
+
+			void reduce() noexcept
+			{
+				mLow %= MODULUS;
+				mHigh %= MODULUS;
+				mWords = 0;
+			}
+
+			std::uint64_t mLow = 0;
+			std::uint64_t mHigh = 0;
+			std::size_t   mWords = 0;
+			unsigned char mPending[sizeof(std::uint32_t)] = {};
+			std::size_t   mPendingBytes = 0;
+	};
+
+	namespace detail
+	{
+		struct Header
+		{
+			char          magic[8];
+			std::uint16_t version;
+			std::uint8_t  endianness;
+			std::uint8_t  reserved0;
+			std::uint32_t elementSize;
+			std::uint64_t count;
+			std::uint64_t checksum;
+			std::uint64_t reserved1;
+		};
+
+		static_assert(sizeof(Header) == 40 && std::is_trivially_copyable_v<Header>);
+
+		static constexpr char MAGIC[8] = {'L', 'I', 'S', 'T', 'S', 'N', 'A', 'P'};
+
+		inline std::uint8_t nativeEndianness() noexcept
+		{
+			return (std::endian::native == std::endian::little) ? 1 : 2;
+		}
+
+		template<typename T>
+		Header makeHeader(std::size_t count, std::uint64_t checksum) noexcept
+		{
+			Header header{};
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = FORMAT_VERSION;
+			header.endianness = nativeEndianness();
+			header.elementSize = sizeof(T);
+			header.count = count;
+			header.checksum = checksum;
+			return header;
+		}
+
+		[[noreturn]] inline void throwSystemError(const char* what)
+		{
+			throw std::system_error(errno, std::generic_category(), what);
+		}
+
+		// writev() until every byte is out. Partial writes (pipes, sockets, > 2 GiB) pick up where they stopped.
+		inline void writeAll(int fd, iovec* parts, int partCount)
+		{
+			while(partCount > 0)
+			{
+				ssize_t written = ::writev(fd, parts, partCount);
+				if(written < 0)
+				{
+					if(errno == EINTR)
+					{
+						continue;
+					}
+
+					throwSystemError("writev");
+				}
+
+				std::size_t remaining = static_cast<std::size_t>(written);
+				while(partCount > 0 && remaining >= parts->iov_len)
+				{
+					remaining -= parts->iov_len;
+					parts++;
+					partCount--;
+				}
+
+				if(partCount > 0)
+				{
+					parts->iov_base = static_cast<char*>(parts->iov_base) + remaining;
+					parts->iov_len -= remaining;
+				}
+			}
+		}
+
+		inline void writeAll(int fd, const void* data, std::size_t bytes)
+		{
+			iovec part{const_cast<void*>(data), bytes};
+			writeAll(fd, &part, 1);
+		}
+
+		// read() until buffer is full. Running out of input first means the snapshot is cut short.
+		inline void readAll(int fd, void* buffer, std::size_t bytes)
+		{
+			unsigned char* output = static_cast<unsigned char*>(buffer);
+			while(bytes > 0)
+			{
+				ssize_t got = ::read(fd, output, bytes);
+				if(got < 0)
+				{
+					if(errno == EINTR)
+					{
+						continue;
+					}
+
+					throwSystemError("read");
+				}
+
+				if(got == 0)
+				{
+					throw std::runtime_error("Snapshot is truncated");
+				}
+
+				output += got;
+				bytes -= static_cast<std::size_t>(got);
+			}
+		}
+
+		template<typename T>
+		Header readHeader(int fd)
+		{
+			Header header;
+			readAll(fd, &header, sizeof(header));
+
+			if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+			{
+				throw std::runtime_error("Not a list snapshot");
+			}
+
+			// Before anything multi-byte gets looked at
+			if(header.endianness != nativeEndianness())
+			{
+				throw std::runtime_error("Snapshot was written with a different byte order");
+			}
+
+			if(header.version != FORMAT_VERSION)
+			{
+				throw std::runtime_error("Unsupported snapshot version " + std::to_string(header.version));
+			}
+
+			if(header.elementSize != sizeof(T))
+			{
+				throw std::runtime_error("Snapshot holds elements of " + std::to_string(header.elementSize) +
+				                         " bytes, expected " + std::to_string(sizeof(T)));
+			}
+
+			if(header.count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+			{
+				throw std::runtime_error("Snapshot element count is out of range");
+			}
+
+			return header;
+		}
+
+		template<typename T>
+		std::size_t chunkElements() noexcept
+		{
+			return std::max<std::size_t>(CHUNK_BYTES / sizeof(T), 1);
+		}
+
+		/**
+		 * How many elements it's safe to allocate for before any of them have been read. The count comes straight
+		 * from the header, so a corrupt or hostile one mustn't turn into a huge allocation.
+		 */
+		template<typename T>
+		std::size_t reserveCount(int fd, const Header& header)
+		{
+			struct stat status;
+			if(::fstat(fd, &status) != 0)
+			{
+				throwSystemError("fstat");
+			}
+
+			if(!S_ISREG(status.st_mode))
+			{
+				return static_cast<std::size_t>(std::min<std::uint64_t>(header.count, chunkElements<T>()));
+			}
+
+			off_t position = ::lseek(fd, 0, SEEK_CUR);
+			if(position < 0)
+			{
+				throwSystemError("lseek");
+			}
+
+			std::uint64_t left = (status.st_size > position) ? static_cast<std::uint64_t>(status.st_size - position) : 0;
+			if(header.count > left / sizeof(T))
+			{
+				throw std::runtime_error("Snapshot is truncated");
+			}
+
+			return static_cast<std::size_t>(header.count);
+		}
+
+		// Uninitialized storage for up to count elements, the elements only ever exist as copied bytes
+		template<typename T>
+		class ChunkBuffer
+		{
+			public:
+				explicit ChunkBuffer(std::size_t count)
+					: mCount(count), mData((count != 0) ? std::allocator<T>().allocate(count) : nullptr)
+				{
+				}
+
+				ChunkBuffer(const ChunkBuffer&) = delete;
+				ChunkBuffer& operator=(const ChunkBuffer&) = delete;
+
+				~ChunkBuffer()
+				{
+					if(mData != nullptr)
+					{
+						std::allocator<T>().deallocate(mData, mCount);
+					}
+				}
+
+				T* data() const noexcept
+				{
+					return mData;
+				}
+
+			private:
+				std::size_t mCount;
+				T*          mData;
+		};
+
+		/**
+		 * Read count elements a chunk at a time and hand every chunk to consume as a span, checking the checksum
+		 * at the end.
+		 */
+		template<typename T, typename Consume>
+		void readElements(int fd, const Header& header, Consume consume)
+		{
+			const std::size_t chunk = chunkElements<T>();
+			ChunkBuffer<T> buffer(static_cast<std::size_t>(std::min<std::uint64_t>(chunk, header.count)));
+
+			Checksum checksum;
+			for(std::uint64_t remaining = header.count; remaining != 0;)
+			{
+				std::size_t count = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, chunk));
+				readAll(fd, buffer.data(), count * sizeof(T));
+				checksum.update(buffer.data(), count * sizeof(T));
+				consume(std::span<const T>(buffer.data(), count));
+				remaining -= count;
+			}
+
+			if(checksum.value() != header.checksum)
+			{
+				throw std::runtime_error("Snapshot checksum mismatch");
+			}
+		}
+	}
+
+	template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+	void save(int fd, const ArrayList<T, Allocator, GrowthPolicy, Instrumentation>& list)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be saved");
+
+		std::size_t bytes = list.size() * sizeof(T);
+
+		Checksum checksum;
+		checksum.update(list.data(), bytes);
+		detail::Header header = detail::makeHeader<T>(list.size(), checksum.value());
+
+		iovec parts[2] = {{&header, sizeof(header)}, {const_cast<T*>(list.data()), bytes}};
+		detail::writeAll(fd, parts, (bytes != 0) ? 2 : 1);
+	}
+
+	template<typename T, typename Allocator, bool DoublyLinked>
+	void save(int fd, const LinkedList<T, Allocator, DoublyLinked>& list)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be saved");
+
+		Checksum checksum;
+		for(const T& value : list)
+		{
+			checksum.update(&value, sizeof(T));
+		}
+
+		detail::Header header = detail::makeHeader<T>(list.size(), checksum.value());
+		detail::writeAll(fd, &header, sizeof(header));
+
+		const std::size_t chunk = detail::chunkElements<T>();
+		detail::ChunkBuffer<T> buffer(std::min(chunk, list.size()));
+
+		std::size_t buffered = 0;
+		for(const T& value : list)
+		{
+			std::memcpy(static_cast<void*>(buffer.data() + buffered), &value, sizeof(T));
+			if(++buffered == chunk)
+			{
+				detail::writeAll(fd, buffer.data(), buffered * sizeof(T));
+				buffered = 0;
+			}
+		}
+
+		if(buffered != 0)
+		{
+			detail::writeAll(fd, buffer.data(), buffered * sizeof(T));
+		}
+	}
+
+	/**
+	 * Replace the contents of list with the snapshot read from fd. Leaves list untouched if anything goes wrong.
+	 */
+	template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+	void load(int fd, ArrayList<T, Allocator, GrowthPolicy, Instrumentation>& list)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be loaded");
+
+		detail::Header header = detail::readHeader<T>(fd);
+
+		ArrayList<T, Allocator, GrowthPolicy, Instrumentation> loaded(list.get_allocator());
+		loaded.reserve(detail::reserveCount<T>(fd, header));
+		detail::readElements<T>(fd, header, [&loaded](std::span<const T> chunk) { loaded.append(chunk); });
+
+		swap(list, loaded);
+	}
+
+	template<typename T, typename Allocator, bool DoublyLinked>
+	void load(int fd, LinkedList<T, Allocator, DoublyLinked>& list)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable elements can be loaded");
+
+		detail::Header header = detail::readHeader<T>(fd);
+
+		LinkedList<T, Allocator, DoublyLinked> loaded(list.get_allocator());
+		detail::readElements<T>(fd, header, [&loaded](std::span<const T> chunk)
+		{
+			for(const T& value : chunk)
+			{
+				loaded.push_back(value);
+			}
+		});
+
+		swap(list, loaded);
+	}
+}
+
+#endif /* INCLUDE_SERIALIZATION_HPP_ */
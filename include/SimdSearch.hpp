@@ -0,0 +1,397 @@
+#ifndef INCLUDE_SIMDSEARCH_HPP_
+#define INCLUDE_SIMDSEARCH_HPP_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DATASTRUCTURES_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * Vectorized linear search over contiguous arrays of 32/64 bit integers, float and double.
+ *
+ * The kernel is picked at runtime from what the CPU supports: AVX-512F, AVX2 or SSE2. Anything that isn't x86 built
+ * with GCC/Clang gets the scalar loop. Comparisons follow operator== exactly, so a NaN is never found and -0.0 matches
+ * 0.0.
+ *
+ * All functions return the index of the first match or size if there is none, the same as ArrayList::find.
+ */
+namespace simd
+{
+	template<typename T>
+	inline constexpr bool is_searchable_v =
+		(std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+		std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+	enum class Level
+	{
+		Scalar,
+		Sse2,
+		Avx2,
+		Avx512
+	};
+
+	// Best instruction set this CPU supports. Only checked once.
+	inline Level level() noexcept
+	{
+#ifdef DATASTRUCTURES_SIMD_X86
+		static const Level detected = []
+		{
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx512f"))
+			{
+				return Level::Avx512;
+			}
+			if(__builtin_cpu_supports("avx2"))
+			{
+				return Level::Avx2;
+			}
+			if(__builtin_cpu_supports("sse2"))
+			{
+				return Level::Sse2;
+			}
+			return Level::Scalar;
+		}();
+
+		return detected;
+#else
+		return Level::Scalar;
+#endif
+	}
+
+	namespace kernels
+	{
+		template<typename Lane>
+		std::size_t findScalar(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			for(std::size_t i = 0; i < size; ++i)
+			{
+				if(data[i] == value)
+				{
+					return i;
+				}
+			}
+
+			return size;
+		}
+
+		template<typename Lane>
+		std::size_t countScalar(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			std::size_t count = 0;
+
+			for(std::size_t i = 0; i < size; ++i)
+			{
+				count += (data[i] == value);
+			}
+
+			return count;
+		}
+
+#ifdef DATASTRUCTURES_SIMD_X86
+		/**
+		 * Each ISA gets one compare function that turns a vector of lanes into a bitmask with one bit per lane. The
+		 * find/count loops on top are the same for every ISA. Integers are compared as raw bits which is the same as
+		 * == for both signed and unsigned.
+		 */
+
+		template<typename Lane>
+		__attribute__((target("sse2"))) inline unsigned compareSse2(const Lane* data, const __m128i& value) noexcept
+		{
+			if constexpr(std::is_same_v<Lane, float>)
+			{
+				return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data), _mm_castsi128_ps(value)));
+			}
+			else if constexpr(std::is_same_v<Lane, double>)
+			{
+				return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(data), _mm_castsi128_pd(value)));
+			}
+			else if constexpr(sizeof(Lane) == 4)
+			{
+				__m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+				return _mm_movemask_ps(_mm_castsi128_ps(equal));
+			}
+			else
+			{
+				// No 64 bit compare before SSE4.1. Both 32 bit halves have to match.
+				__m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), value);
+				equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+				return _mm_movemask_pd(_mm_castsi128_pd(equal));
+			}
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx2"))) inline unsigned compareAvx2(const Lane* data, const __m256i& value) noexcept
+		{
+			if constexpr(std::is_same_v<Lane, float>)
+			{
+				return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(data), _mm256_castsi256_ps(value), _CMP_EQ_OQ));
+			}
+			else if constexpr(std::is_same_v<Lane, double>)
+			{
+				return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(data), _mm256_castsi256_pd(value), _CMP_EQ_OQ));
+			}
+			else if constexpr(sizeof(Lane) == 4)
+			{
+				__m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+				return _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+			}
+			else
+			{
+				__m256i equal = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), value);
+				return _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+			}
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx512f"))) inline unsigned compareAvx512(const Lane* data, const __m512i& value) noexcept
+		{
+			if constexpr(std::is_same_v<Lane, float>)
+			{
+				return _mm512_cmp_ps_mask(_mm512_loadu_ps(data), _mm512_castsi512_ps(value), _CMP_EQ_OQ);
+			}
+			else if constexpr(std::is_same_v<Lane, double>)
+			{
+				return _mm512_cmp_pd_mask(_mm512_loadu_pd(data), _mm512_castsi512_pd(value), _CMP_EQ_OQ);
+			}
+			else if constexpr(sizeof(Lane) == 4)
+			{
+				return _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(data), value);
+			}
+			else
+			{
+				return _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(data), value);
+			}
+		}
+
+		// Broadcast value into every lane of a vector
+
+		template<typename Lane>
+		__attribute__((target("sse2"))) inline __m128i splatSse2(Lane value) noexcept
+		{
+			if constexpr(sizeof(Lane) == 4)
+			{
+				return _mm_set1_epi32(std::bit_cast<std::int32_t>(value));
+			}
+			else
+			{
+				return _mm_set1_epi64x(std::bit_cast<std::int64_t>(value));
+			}
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx2"))) inline __m256i splatAvx2(Lane value) noexcept
+		{
+			if constexpr(sizeof(Lane) == 4)
+			{
+				return _mm256_set1_epi32(std::bit_cast<std::int32_t>(value));
+			}
+			else
+			{
+				return _mm256_set1_epi64x(std::bit_cast<std::int64_t>(value));
+			}
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx512f"))) inline __m512i splatAvx512(Lane value) noexcept
+		{
+			if constexpr(sizeof(Lane) == 4)
+			{
+				return _mm512_set1_epi32(std::bit_cast<std::int32_t>(value));
+			}
+			else
+			{
+				return _mm512_set1_epi64(std::bit_cast<std::int64_t>(value));
+			}
+		}
+
+		/**
+		 * Four vectors per iteration so there are enough loads in flight to keep up with memory. The masks are OR'd
+		 * together and we only work out which lane matched once something did.
+		 */
+		template<typename Lane, typename Vector, unsigned (*Compare)(const Lane*, const Vector&)>
+		inline __attribute__((always_inline)) std::size_t findVector(const Lane* data, std::size_t size, Lane value,
+		                                                             const Vector& needle) noexcept
+		{
+			constexpr std::size_t LANES = sizeof(Vector) / sizeof(Lane);
+
+			std::size_t i = 0;
+			for(; i + 4 * LANES <= size; i += 4 * LANES)
+			{
+				unsigned m0 = Compare(data + i, needle);
+				unsigned m1 = Compare(data + i + LANES, needle);
+				unsigned m2 = Compare(data + i + 2 * LANES, needle);
+				unsigned m3 = Compare(data + i + 3 * LANES, needle);
+
+				if((m0 | m1 | m2 | m3) != 0)
+				{
+					std::uint64_t all = std::uint64_t(m0) | (std::uint64_t(m1) << LANES) |
+					                    (std::uint64_t(m2) << (2 * LANES)) | (std::uint64_t(m3) << (3 * LANES));
+					return i + static_cast<std::size_t>(std::countr_zero(all));
+				}
+			}
+
+			for(; i + LANES <= size; i += LANES)
+			{
+				unsigned mask = Compare(data + i, needle);
+				if(mask != 0)
+				{
+					return i + static_cast<std::size_t>(std::countr_zero(mask));
+				}
+			}
+
+			std::size_t rest = findScalar(data + i, size - i, value);
+			return i + rest;
+		}
+
+		template<typename Lane, typename Vector, unsigned (*Compare)(const Lane*, const Vector&)>
+		inline __attribute__((always_inline)) std::size_t countVector(const Lane* data, std::size_t size, Lane value,
+		                                                              const Vector& needle) noexcept
+		{
+			constexpr std::size_t LANES = sizeof(Vector) / sizeof(Lane);
+
+			std::size_t count = 0;
+			std::size_t i = 0;
+			for(; i + LANES <= size; i += LANES)
+			{
+				count += static_cast<std::size_t>(std::popcount(Compare(data + i, needle)));
+			}
+
+			return count + countScalar(data + i, size - i, value);
+		}
+
+		template<typename Lane>
+		__attribute__((target("sse2"))) std::size_t findSse2(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			return findVector<Lane, __m128i, compareSse2<Lane>>(data, size, value, splatSse2(value));
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx2"))) std::size_t findAvx2(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			return findVector<Lane, __m256i, compareAvx2<Lane>>(data, size, value, splatAvx2(value));
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx512f"))) std::size_t findAvx512(const Lane* data, std::size_t size,
+		                                                          Lane value) noexcept
+		{
+			return findVector<Lane, __m512i, compareAvx512<Lane>>(data, size, value, splatAvx512(value));
+		}
+
+		template<typename Lane>
+		__attribute__((target("sse2"))) std::size_t countSse2(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			return countVector<Lane, __m128i, compareSse2<Lane>>(data, size, value, splatSse2(value));
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx2"))) std::size_t countAvx2(const Lane* data, std::size_t size, Lane value) noexcept
+		{
+			return countVector<Lane, __m256i, compareAvx2<Lane>>(data, size, value, splatAvx2(value));
+		}
+
+		template<typename Lane>
+		__attribute__((target("avx512f"))) std::size_t countAvx512(const Lane* data, std::size_t size,
+		                                                           Lane value) noexcept
+		{
+			return countVector<Lane, __m512i, compareAvx512<Lane>>(data, size, value, splatAvx512(value));
+		}
+#endif
+
+		// Integers are searched by their bits, so every 4 byte integer shares the uint32_t kernels and so on
+		template<typename T>
+		using lane_t = std::conditional_t<std::is_floating_point_v<T>, T,
+		                                  std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>;
+	}
+
+	template<typename T>
+	std::size_t find(const T* data, std::size_t size, const T& value) noexcept
+	{
+		static_assert(is_searchable_v<T>, "simd::find needs 32/64 bit integers, float or double");
+
+		using Lane = kernels::lane_t<T>;
+		const Lane* lanes = reinterpret_cast<const Lane*>(data);
+		Lane needle = std::bit_cast<Lane>(value);
+
+#ifdef DATASTRUCTURES_SIMD_X86
+		switch(level())
+		{
+			case Level::Avx512: return kernels::findAvx512(lanes, size, needle);
+			case Level::Avx2:   return kernels::findAvx2(lanes, size, needle);
+			case Level::Sse2:   return kernels::findSse2(lanes, size, needle);
+			case Level::Scalar: break;
+		}
+#endif
+
+		return kernels::findScalar(lanes, size, needle);
+	}
+
+	template<typename T>
+	std::size_t count(const T* data, std::size_t size, const T& value) noexcept
+	{
+		static_assert(is_searchable_v<T>, "simd::count needs 32/64 bit integers, float or double");
+
+		using Lane = kernels::lane_t<T>;
+		const Lane* lanes = reinterpret_cast<const Lane*>(data);
+		Lane needle = std::bit_cast<Lane>(value);
+
+#ifdef DATASTRUCTURES_SIMD_X86
+		switch(level())
+		{
+			case Level::Avx512: return kernels::countAvx512(lanes, size, needle);
+			case Level::Avx2:   return kernels::countAvx2(lanes, size, needle);
+			case Level::Sse2:   return kernels::countSse2(lanes, size, needle);
+			case Level::Scalar: break;
+		}
+#endif
+
+		return kernels::countScalar(lanes, size, needle);
+	}
+
+	/**
+	 * find_if for arbitrary predicates. There's no instruction set to dispatch to here, instead the predicate is run
+	 * over whole blocks without an early exit so the compiler can vectorize the block. Only once a block contains a
+	 * match do we go back and find the first one.
+	 *
+	 * The predicate may run on elements past the first match (and twice on the block that matched) so it must not
+	 * have side effects.
+	 */
+	template<typename T, typename Predicate>
+	std::size_t find_if(const T* data, std::size_t size, Predicate predicate)
+	{
+		constexpr std::size_t BLOCK = (sizeof(T) >= 64) ? 1 : 64 / sizeof(T) * 2;
+
+		std::size_t i = 0;
+		for(; i + BLOCK <= size; i += BLOCK)
+		{
+			bool any = false;
+			for(std::size_t j = 0; j < BLOCK; ++j)
+			{
+				any |= static_cast<bool>(predicate(data[i + j]));
+			}
+
+			if(any)
+			{
+				break;
+			}
+		}
+
+		for(; i < size; ++i)
+		{
+			if(predicate(data[i]))
+			{
+				return i;
+			}
+		}
+
+		return size;
+	}
+}
+
+#endif /* INCLUDE_SIMDSEARCH_HPP_ */
@@ -0,0 +1,262 @@
+#ifndef INCLUDE_SLABALLOCATOR_HPP_
+#define INCLUDE_SLABALLOCATOR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Arena that carves fixed size slots out of big blocks. Meant for node based containers which allocate one small
+ * object at a time: an allocation is a free list pop or a pointer bump, a deallocation a free list push, and nothing
+ * goes back to the system until release() or the arena is destroyed.
+ *
+ * Every distinct (size, alignment) gets its own pool of blocks, so one arena can serve the different node types a
+ * container rebinds its allocator to.
+ *
+ * Not thread safe. Share an arena between containers that live on the same thread.
+ */
+class SlabArena
+{
+	public:
+		// Bytes per block. Big enough to amortize the system allocation, small enough not to waste much on short lists.
+		static constexpr std::size_t DEFAULT_BLOCK_BYTES = 64 * 1024;
+
+		explicit SlabArena(std::size_t blockBytes = DEFAULT_BLOCK_BYTES) noexcept
+			: mBlockBytes(blockBytes)
+		{
+		}
+
+		SlabArena(const SlabArena&) = delete;
+		SlabArena& operator=(const SlabArena&) = delete;
+
+		~SlabArena()
+		{
+			release();
+		}
+
+		void* allocate(std::size_t size, std::size_t alignment)
+		{
+			Pool& pool = poolFor(size, alignment);
+
+			if(pool.freeList != nullptr)
+			{
+				FreeSlot* slot = pool.freeList;
+				pool.freeList = slot->next;
+				return slot;
+			}
+
+			if(pool.cursor == pool.end)
+			{
+				std::size_t bytes = std::max(mBlockBytes / pool.slotSize, std::size_t(1)) * pool.slotSize;
+				char* block = static_cast<char*>(::operator new(bytes, std::align_val_t(pool.alignment)));
+				mBlocks.push_back(Block{block, pool.alignment});
+				pool.cursor = block;
+				pool.end = block + bytes;
+			}
+
+			void* slot = pool.cursor;
+			pool.cursor += pool.slotSize;
+			return slot;
+		}
+
+		// Puts the slot on its pool's free list. The memory stays with the arena.
+		void deallocate(void* slot, std::size_t size, std::size_t alignment) noexcept
+		{
+			Pool& pool = *findPool(slotSize(size, alignment), std::max(alignment, alignof(FreeSlot)));
+			FreeSlot* freed = ::new(slot) FreeSlot{pool.freeList};
+			pool.freeList = freed;
+		}
+
+		/**
+		 * Give every block back to the system in one pass, O(blocks) rather than O(allocations). Whatever was still
+		 * allocated from the arena is gone afterwards, without its destructor being run.
+		 */
+		void release() noexcept
+		{
+			for(const Block& block : mBlocks)
+			{
+				::operator delete(block.memory, std::align_val_t(block.alignment));
+			}
+
+			mBlocks.clear();
+			mPools.clear();
+		}
+
+		std::size_t block_count() const noexcept
+		{
+			return mBlocks.size();
+		}
+
+	private:
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		struct Pool
+		{
+			std::size_t slotSize;
+			std::size_t alignment;
+			FreeSlot*   freeList = nullptr;
+			char*       cursor = nullptr;
+			char*       end = nullptr;
+		};
+
+		struct Block
+		{
+			void*       memory;
+			std::size_t alignment;
+		};
+
+		// Every slot has to be able to hold a free list link and keep the next slot aligned
+		static std::size_t slotSize(std::size_t size, std::size_t alignment) noexcept
+		{
+			alignment = std::max(alignment, alignof(FreeSlot));
+			size = std::max(size, sizeof(FreeSlot));
+			return (size + alignment - 1) / alignment * alignment;
+		}
+
+		Pool* findPool(std::size_t size, std::size_t alignment) noexcept
+		{
+			for(Pool& pool : mPools)
+			{
+				if(pool.slotSize == size && pool.alignment == alignment)
+				{
+					return &pool;
+				}
+			}
+
+			return nullptr;
+		}
+
+		Pool& poolFor(std::size_t size, std::size_t alignment)
+		{
+			std::size_t slot = slotSize(size, alignment);
+			alignment = std::max(alignment, alignof(FreeSlot));
+
+			if(Pool* pool = findPool(slot, alignment))
+			{
+				return *pool;
+			}
+
+			mPools.push_back(Pool{slot, alignment});
+			return mPools.back();
+		}
+
+		std::size_t mBlockBytes;
+		std::vector<Pool> mPools;
+		std::vector<Block> mBlocks;
+};
+
+/**
+ * Standard allocator on top of a shared SlabArena. Single objects come from the arena, anything bigger (which node
+ * based containers never ask for) goes to operator new.
+ *
+ * A default constructed allocator creates its own arena. Copies and rebound copies share it, so a container and the
+ * node type it rebinds to use the same arena, and so do several containers built from one allocator:
+ *
+ *   SlabAllocator<int> slab;
+ *   LinkedList<int, SlabAllocator<int>> a(slab), b(slab);
+ */
+template<typename T>
+class SlabAllocator
+{
+	public:
+		using value_type                             = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap            = std::true_type;
+		using is_always_equal                        = std::false_type;
+
+		SlabAllocator()
+			: mArena(std::make_shared<SlabArena>())
+		{
+		}
+
+		explicit SlabAllocator(std::shared_ptr<SlabArena> arena) noexcept
+			: mArena(std::move(arena))
+		{
+		}
+
+		SlabAllocator(const SlabAllocator& other) noexcept = default;
+
+		// Moving is copying: a moved from allocator has to keep working and compare equal to the new one, so both
+		// end up sharing the arena
+		SlabAllocator(SlabAllocator&& other) noexcept
+			: mArena(other.mArena)
+		{
+		}
+
+		template<typename U>
+		SlabAllocator(const SlabAllocator<U>& other) noexcept
+			: mArena(other.arena())
+		{
+		}
+
+		SlabAllocator& operator=(const SlabAllocator& other) noexcept = default;
+
+		SlabAllocator& operator=(SlabAllocator&& other) noexcept
+		{
+			mArena = other.mArena;
+			return *this;
+		}
+
+		T* allocate(std::size_t count)
+		{
+			if(count == 1)
+			{
+				return static_cast<T*>(mArena->allocate(sizeof(T), alignof(T)));
+			}
+
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* pointer, std::size_t count) noexcept
+		{
+			if(count == 1)
+			{
+				mArena->deallocate(pointer, sizeof(T), alignof(T));
+			}
+			else
+			{
+				std::allocator<T>().deallocate(pointer, count);
+			}
+		}
+
+		/**
+		 * Release the whole arena (see SlabArena::release()) if this allocator is the only one using it and report
+		 * whether it did. Containers call this to drop all their nodes at once instead of one by one. A container that
+		 * was moved from still holds the arena, so it keeps the nodes of the one it moved to from being dropped this
+		 * way until it goes away too.
+		 */
+		bool try_release() noexcept
+		{
+			if(mArena.use_count() != 1)
+			{
+				return false;
+			}
+
+			mArena->release();
+			return true;
+		}
+
+		const std::shared_ptr<SlabArena>& arena() const noexcept
+		{
+			return mArena;
+		}
+
+		template<typename U>
+		friend bool operator==(const SlabAllocator& left, const SlabAllocator<U>& right) noexcept
+		{
+			return left.mArena == right.arena();
+		}
+
+	private:
+		std::shared_ptr<SlabArena> mArena;
+};
+
+#endif /* INCLUDE_SLABALLOCATOR_HPP_ */
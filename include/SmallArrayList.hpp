@@ -0,0 +1,749 @@
+#ifndef INCLUDE_SMALLARRAYLIST_HPP_
+#define INCLUDE_SMALLARRAYLIST_HPP_
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "ContiguousIterator.hpp"
+#include "GrowthPolicy.hpp"
+#include "Relocatable.hpp"
+#include "SimdSearch.hpp"
+
+/**
+ * ArrayList with room for N elements inside the object itself. Nothing is allocated until the list grows past N,
+ * at which point the elements move to a heap buffer from Allocator and it behaves like a regular ArrayList. Shrinking
+ * back to N or fewer elements moves them back inline.
+ *
+ * Access:  O(1) (array lookup)
+ * Insert:  O(n) (might have to shift all elements to right)
+ * Removal: O(n) (might have to shift all elements to left)
+ * Add:     O(n) (list could be full and have to copy everything)
+ *
+ * Moving or swapping a list that is still inline moves its elements one by one, so unlike ArrayList those are O(n).
+ */
+template<typename T, std::size_t N = 16, typename Allocator = std::allocator<T>,
+         typename GrowthPolicy = DoublingGrowth>
+class SmallArrayList
+{
+	static_assert(N > 0, "Use ArrayList if there is no inline storage");
+
+	public:
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = T&;
+		using const_reference        = const T&;
+		using iterator               = ContiguousIterator<T>;
+		using const_iterator         = ContiguousIterator<const T>;
+		using reverse_iterator       = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		// Default constructor
+		SmallArrayList() noexcept(noexcept(Allocator())) = default;
+
+		explicit SmallArrayList(const Allocator& allocator) noexcept
+			: mAllocator(allocator)
+		{
+		}
+
+		SmallArrayList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			reserve(il.size());
+
+			for(const T& val : il)
+			{
+				this->push_back(val);
+			}
+		}
+
+		// User defined constructor
+		SmallArrayList(T contents[], size_t listSize, const Allocator& allocator = Allocator())
+			: mAllocator(allocator)
+		{
+			reserve(listSize);
+
+			for(size_t i = 0; i < listSize; ++i)
+			{
+				this->push_back(contents[i]);
+			}
+		}
+
+		// Copy constructor
+		SmallArrayList(const SmallArrayList& other)
+			: mAllocator(AllocTraits::select_on_container_copy_construction(other.mAllocator))
+		{
+			reserve(other.mCurrentSize);
+
+			for(size_t i = 0; i < other.mCurrentSize; ++i)
+			{
+				this->push_back(other.mContents[i]);
+			}
+		}
+
+		// Move constructor should never throw
+		SmallArrayList(SmallArrayList&& other) noexcept(detail::is_relocatable_v<T>)
+			: mAllocator(std::move(other.mAllocator))
+		{
+			forwardMove(std::forward<SmallArrayList>(other));
+		}
+
+		/**
+		 * Copy assignment
+		 * The copy is built with our own allocator, or with other's when that one propagates on copy assignment, and
+		 * then moved in. The allocators are equal by then so a heap buffer just changes hands.
+		 */
+		SmallArrayList& operator=(const SmallArrayList& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(AllocTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!AllocTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+			}
+
+			SmallArrayList temp(mAllocator);
+			temp.reserve(other.mCurrentSize);
+			for(size_t i = 0; i < other.mCurrentSize; ++i)
+			{
+				temp.push_back(other.mContents[i]);
+			}
+
+			*this = std::move(temp);
+			return *this;
+		}
+
+		/**
+		 * Move assignment
+		 * A heap buffer is adopted as is. Inline elements have to be moved over one at a time.
+		 */
+		SmallArrayList& operator=(SmallArrayList&& other) noexcept(detail::is_relocatable_v<T> &&
+		                                                           (AllocTraits::propagate_on_container_move_assignment::value ||
+		                                                            AllocTraits::is_always_equal::value))
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(AllocTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+			}
+			else if constexpr(!AllocTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator && !other.isInline())
+				{
+					reserve(other.mCurrentSize);
+					for(size_t i = 0; i < other.mCurrentSize; ++i)
+					{
+						this->push_back(std::move(other.mContents[i]));
+					}
+
+					other.release();
+					return *this;
+				}
+			}
+
+			forwardMove(std::forward<SmallArrayList>(other));
+			return *this;
+		}
+
+		virtual ~SmallArrayList() noexcept
+		{
+			release();
+		}
+
+		/**
+		 * Swap. Only a pointer swap when both lists live on the heap.
+		 * Like the standard containers, the allocators have to propagate on swap or compare equal.
+		 */
+		friend void swap(SmallArrayList& left, SmallArrayList& right) noexcept(detail::is_relocatable_v<T>)
+		{
+			using std::swap;
+
+			if(!left.isInline() && !right.isInline())
+			{
+				std::swap(left.mCurrentSize, right.mCurrentSize);
+				std::swap(left.mMaxSize, right.mMaxSize);
+				std::swap(left.mContents, right.mContents);
+
+				if constexpr(AllocTraits::propagate_on_container_swap::value)
+				{
+					swap(left.mAllocator, right.mAllocator);
+				}
+
+				return;
+			}
+
+			SmallArrayList temp(std::move(left));
+			left = std::move(right);
+			right = std::move(temp);
+		}
+
+		// Iterators:
+
+		iterator begin() noexcept
+		{
+			return iterator(mContents);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mContents);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(mContents + mCurrentSize);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(mContents + mCurrentSize);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		reverse_iterator rbegin() noexcept
+		{
+			return reverse_iterator(end());
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return const_reverse_iterator(end());
+		}
+
+		const_reverse_iterator crbegin() const noexcept
+		{
+			return rbegin();
+		}
+
+		reverse_iterator rend() noexcept
+		{
+			return reverse_iterator(begin());
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return const_reverse_iterator(begin());
+		}
+
+		const_reverse_iterator crend() const noexcept
+		{
+			return rend();
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return mAllocator;
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mCurrentSize;
+		}
+
+		size_t max_size() const noexcept
+		{
+			return AllocTraits::max_size(mAllocator);
+		}
+
+		size_t capacity() const noexcept
+		{
+			return mMaxSize;
+		}
+
+		bool empty() const noexcept
+		{
+			return (mCurrentSize == 0);
+		}
+
+		// True while the elements are stored inside the object
+		bool is_inline() const noexcept
+		{
+			return isInline();
+		}
+
+		/**
+		 * Make room for at least newCapacity elements without reallocating. Never shrinks.
+		 */
+		void reserve(size_t newCapacity) // throw length_error
+		{
+			if(newCapacity > max_size())
+			{
+				throw std::length_error("Capacity exceeds max_size");
+			}
+
+			if(newCapacity > mMaxSize)
+			{
+				reallocate(newCapacity);
+			}
+		}
+
+		/**
+		 * Drop spare heap capacity. Moves back inline when the elements fit.
+		 */
+		void shrink_to_fit()
+		{
+			if(mMaxSize > std::max(mCurrentSize, N))
+			{
+				reallocate(mCurrentSize);
+			}
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const SmallArrayList*>(this)->operator[](index));
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return mContents[index];
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const SmallArrayList*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			return mContents[index];
+		}
+
+		T& front()
+		{
+			return const_cast<T&>(static_cast<const SmallArrayList*>(this)->front());
+		}
+
+		const T& front() const
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mContents[0];
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const SmallArrayList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mContents[mCurrentSize - 1];
+		}
+
+		T* data() noexcept
+		{
+			return mContents;
+		}
+
+		const T* data() const noexcept
+		{
+			return mContents;
+		}
+
+		// Modifiers
+
+		void push_front (const T& val)
+		{
+			insert(val, 0);
+		}
+
+		void push_front (T&& val)
+		{
+			insert(std::move(val), 0);
+		}
+
+		void push_back (const T& val)
+		{
+			insert(val, mCurrentSize);
+		}
+
+		void push_back (T&& val)
+		{
+			insert(std::move(val), mCurrentSize);
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(mCurrentSize - 1);
+		}
+
+		/**
+		 * Construct an element in place at the end from args. Returns the new element.
+		 */
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			return emplaceAt(mCurrentSize, std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Construct an element in place at insertIndex from args. Returns the new element.
+		 */
+		template<typename... Args>
+		T& emplace(std::size_t insertIndex, Args&&... args) // throw out_of_range
+		{
+			return emplaceAt(insertIndex, std::forward<Args>(args)...);
+		}
+
+		void insert(const T& val, std::size_t insertIndex)
+		{
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex)
+		{
+			emplaceAt(insertIndex, std::move(val));
+		}
+
+		void replace(const T& val, std::size_t insertIndex)
+		{
+			at(insertIndex) = val;
+		}
+
+		void replace(T&& val, std::size_t insertIndex)
+		{
+			at(insertIndex) = std::move(val);
+		}
+
+		T erase(std::size_t index)
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			T removed = std::move(mContents[index]);
+
+			if constexpr(detail::is_relocatable_v<T>)
+			{
+				AllocTraits::destroy(mAllocator, mContents + index);
+				detail::relocate(mAllocator, mContents + index + 1, mContents + mCurrentSize, mContents + index);
+			}
+			else
+			{
+				std::move(mContents + index + 1, mContents + mCurrentSize, mContents + index);
+				AllocTraits::destroy(mAllocator, mContents + mCurrentSize - 1);
+			}
+
+			mCurrentSize--;
+
+			if(!isInline())
+			{
+				size_t shrunk = GrowthPolicy::shrink(mMaxSize, mCurrentSize, sizeof(T));
+				if(shrunk < mMaxSize)
+				{
+					reallocate(shrunk);
+				}
+			}
+
+			return removed;
+		}
+
+		void remove(const T& val)
+		{
+			size_t index = find(val);
+			if(index != mCurrentSize)
+			{
+				erase(index);
+			}
+		}
+
+		// Return index of element or size if not found. Arithmetic types are searched with SIMD like ArrayList.
+		size_t find(const T& val) const
+		{
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::find(mContents, mCurrentSize, val);
+			}
+			else
+			{
+				size_t index = mCurrentSize;
+
+				for(size_t i = 0; i < mCurrentSize; ++i)
+				{
+					if(val == mContents[i])
+					{
+						index = i;
+						break;
+					}
+				}
+
+				return index;
+			}
+		}
+
+		bool contains(const T& data) const
+		{
+			return find(data) != mCurrentSize;
+		}
+
+	private:
+		using AllocTraits = std::allocator_traits<Allocator>;
+
+		T* inlineBuffer() noexcept
+		{
+			return reinterpret_cast<T*>(mInline);
+		}
+
+		bool isInline() const noexcept
+		{
+			return mContents == reinterpret_cast<const T*>(mInline);
+		}
+
+		void destroy(T* first, T* last) noexcept
+		{
+			for(; first != last; ++first)
+			{
+				AllocTraits::destroy(mAllocator, first);
+			}
+		}
+
+		// Destroys every live element and frees a heap buffer. Leaves the list empty and inline.
+		void release() noexcept
+		{
+			destroy(mContents, mContents + mCurrentSize);
+
+			if(!isInline())
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = inlineBuffer();
+			mCurrentSize = 0;
+			mMaxSize = N;
+		}
+
+		/**
+		 * Move the elements to a buffer with room for maxSize. Anything that fits in N goes back to the inline
+		 * buffer. If we're already inline and stay inline there's nothing to do.
+		 */
+		void reallocate(size_t maxSize)
+		{
+			bool toInline = maxSize <= N;
+			if(toInline && isInline())
+			{
+				return;
+			}
+
+			T* contents = toInline ? inlineBuffer() : AllocTraits::allocate(mAllocator, maxSize);
+
+			if constexpr(detail::is_relocatable_v<T>)
+			{
+				detail::relocate(mAllocator, mContents, mContents + mCurrentSize, contents);
+			}
+			else
+			{
+				T* built = contents;
+				try
+				{
+					for(size_t i = 0; i < mCurrentSize; ++i, ++built)
+					{
+						AllocTraits::construct(mAllocator, built, std::move_if_noexcept(mContents[i]));
+					}
+				}
+				catch(...)
+				{
+					destroy(contents, built);
+					if(!toInline)
+					{
+						AllocTraits::deallocate(mAllocator, contents, maxSize);
+					}
+					throw;
+				}
+
+				destroy(mContents, mContents + mCurrentSize);
+			}
+
+			if(!isInline())
+			{
+				AllocTraits::deallocate(mAllocator, mContents, mMaxSize);
+			}
+
+			mContents = contents;
+			mMaxSize = toInline ? N : maxSize;
+		}
+
+		template<typename... Args>
+		T& emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			if(mCurrentSize == mMaxSize)
+			{
+				// Grab the value before the old buffer goes away, args could be one of our own elements.
+				T temp(std::forward<Args>(args)...);
+				reallocate(GrowthPolicy::grow(mMaxSize, mCurrentSize + 1, sizeof(T)));
+				return emplaceAt(insertIndex, std::move(temp));
+			}
+
+			if(insertIndex == mCurrentSize)
+			{
+				AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::forward<Args>(args)...);
+			}
+			else
+			{
+				// args could point into the part we're about to shift so build the element first
+				T temp(std::forward<Args>(args)...);
+
+				if constexpr(detail::is_relocatable_v<T>)
+				{
+					detail::relocate(mAllocator, mContents + insertIndex, mContents + mCurrentSize,
+					                 mContents + insertIndex + 1);
+					AllocTraits::construct(mAllocator, mContents + insertIndex, std::move(temp));
+				}
+				else
+				{
+					AllocTraits::construct(mAllocator, mContents + mCurrentSize, std::move(mContents[mCurrentSize - 1]));
+					std::move_backward(mContents + insertIndex, mContents + mCurrentSize - 1, mContents + mCurrentSize);
+					mContents[insertIndex] = std::move(temp);
+				}
+			}
+
+			mCurrentSize++;
+			return mContents[insertIndex];
+		}
+
+		// Takes over the contents of other. Expects this to be empty.
+		void forwardMove(SmallArrayList&& other) noexcept(detail::is_relocatable_v<T>)
+		{
+			if(other.isInline())
+			{
+				if constexpr(detail::is_relocatable_v<T>)
+				{
+					detail::relocate(mAllocator, other.mContents, other.mContents + other.mCurrentSize, mContents);
+				}
+				else
+				{
+					for(size_t i = 0; i < other.mCurrentSize; ++i)
+					{
+						AllocTraits::construct(mAllocator, mContents + i, std::move(other.mContents[i]));
+					}
+					destroy(other.mContents, other.mContents + other.mCurrentSize);
+				}
+
+				mCurrentSize = std::exchange(other.mCurrentSize, 0);
+				return;
+			}
+
+			mContents = std::exchange(other.mContents, other.inlineBuffer());
+			mCurrentSize = std::exchange(other.mCurrentSize, 0);
+			mMaxSize = std::exchange(other.mMaxSize, N);
+		}
+
+		size_t mCurrentSize = 0;
+		size_t mMaxSize = N;
+		T*     mContents = inlineBuffer();
+		[[no_unique_address]] Allocator mAllocator;
+		alignas(T) unsigned char mInline[N * sizeof(T)];
+};
+
+// Comparison operators
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return !operator==(left,right);
+}
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator< (const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator> (const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return  operator< (right,left);
+}
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return !operator> (left,right);
+}
+
+template<typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const SmallArrayList<T, N, Allocator, GrowthPolicy>& left,
+                       const SmallArrayList<T, N, Allocator, GrowthPolicy>& right)
+{
+	return !operator< (left,right);
+}
+
+#endif /* INCLUDE_SMALLARRAYLIST_HPP_ */
@@ -0,0 +1,416 @@
+#ifndef INCLUDE_SORTEDARRAYLIST_HPP_
+#define INCLUDE_SORTEDARRAYLIST_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "ArrayList.hpp"
+
+/**
+ * Search layouts for SortedArrayList.
+ *
+ * FlatLayout searches the sorted array itself with a branchless binary search. No extra memory and nothing to
+ * rebuild, but the first few probes of every search land far apart and each one is a cache miss.
+ *
+ * EytzingerLayout keeps a second copy of the elements in BFS order of the implicit search tree (children of slot k
+ * are 2k and 2k + 1). The top of the tree shares a handful of cache lines and the next levels can be prefetched, so
+ * big tables need far fewer misses per search. The copy is rebuilt lazily on the first search after a change, so
+ * batch up inserts before searching.
+ */
+struct FlatLayout
+{
+};
+
+struct EytzingerLayout
+{
+};
+
+namespace detail
+{
+	inline void prefetch(const void* address) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(address);
+#else
+		(void)address;
+#endif
+	}
+}
+
+/**
+ * ArrayList that keeps its elements ordered by Compare. Lookups are O(log n) instead of a linear find().
+ *
+ * Access:  O(1) (array lookup)
+ * Search:  O(log n) (binary search)
+ * Insert:  O(n) (shifts everything after the insert position right)
+ * Removal: O(n) (shifts everything after the removed element left)
+ *
+ * Elements are only handed out as const so nobody can break the ordering. Equal elements keep their insertion order.
+ *
+ * With EytzingerLayout searches may rebuild the search tree, so concurrent readers need to call rebuild() once after
+ * the last change before sharing the list.
+ */
+template<typename T, typename Compare = std::less<T>, typename Layout = FlatLayout,
+         typename Allocator = std::allocator<T>>
+class SortedArrayList
+{
+	public:
+		using value_type             = T;
+		using allocator_type         = Allocator;
+		using size_type              = std::size_t;
+		using const_reference        = const T&;
+		using const_iterator         = typename ArrayList<T, Allocator>::const_iterator;
+		using const_reverse_iterator = typename ArrayList<T, Allocator>::const_reverse_iterator;
+
+		SortedArrayList() = default;
+
+		explicit SortedArrayList(const Compare& compare, const Allocator& allocator = Allocator())
+			: mContents(allocator), mCompare(compare)
+		{
+		}
+
+		SortedArrayList(const std::initializer_list<T>& il, const Compare& compare = Compare(),
+		                const Allocator& allocator = Allocator())
+			: mContents(allocator), mCompare(compare)
+		{
+			insert(il.begin(), il.end());
+		}
+
+		// Iterators: (const only, writing through them could break the order)
+
+		const_iterator begin() const noexcept
+		{
+			return mContents.begin();
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return mContents.cbegin();
+		}
+
+		const_iterator end() const noexcept
+		{
+			return mContents.end();
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return mContents.cend();
+		}
+
+		const_reverse_iterator rbegin() const noexcept
+		{
+			return mContents.rbegin();
+		}
+
+		const_reverse_iterator rend() const noexcept
+		{
+			return mContents.rend();
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mContents.size();
+		}
+
+		size_t capacity() const noexcept
+		{
+			return mContents.capacity();
+		}
+
+		bool empty() const noexcept
+		{
+			return mContents.empty();
+		}
+
+		void reserve(size_t newCapacity)
+		{
+			mContents.reserve(newCapacity);
+		}
+
+		// Element access:
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return mContents[index];
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			return mContents.at(index);
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			return mContents.front();
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			return mContents.back();
+		}
+
+		const T* data() const noexcept
+		{
+			return mContents.data();
+		}
+
+		// Modifiers
+
+		/**
+		 * Insert val after any elements equal to it. Returns the index it ended up at.
+		 */
+		size_t insert(const T& val)
+		{
+			size_t index = upper_bound(val);
+			mContents.insert(val, index);
+			mDirty = true;
+			return index;
+		}
+
+		size_t insert(T&& val)
+		{
+			size_t index = upper_bound(val);
+			mContents.insert(std::move(val), index);
+			mDirty = true;
+			return index;
+		}
+
+		/**
+		 * Batch insert. The new elements are appended in one go, sorted and merged into place, which is
+		 * O(n + k log k) instead of k separate O(n) inserts.
+		 */
+		template<std::input_iterator It>
+		void insert(It first, It last)
+		{
+			size_t oldSize = mContents.size();
+			mContents.append(first, last);
+
+			auto middle = mContents.begin() + static_cast<std::ptrdiff_t>(oldSize);
+			std::stable_sort(middle, mContents.end(), mCompare);
+			std::inplace_merge(mContents.begin(), middle, mContents.end(), mCompare);
+			mDirty = true;
+		}
+
+		T erase(size_t index) // throw out_of_range
+		{
+			T removed = mContents.erase(index);
+			mDirty = true;
+			return removed;
+		}
+
+		// Remove the first element equal to val. Returns whether there was one.
+		bool remove(const T& val)
+		{
+			size_t index = find(val);
+			if(index == size())
+			{
+				return false;
+			}
+
+			erase(index);
+			return true;
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(size() - 1);
+		}
+
+		void clear() noexcept
+		{
+			mContents.clear();
+			mDirty = true;
+		}
+
+		// Lookup
+		// Everything returns indexes into the sorted order, size() meaning past the end.
+
+		// Index of the first element not less than val
+		size_t lower_bound(const T& val) const
+		{
+			if constexpr(std::is_same_v<Layout, EytzingerLayout>)
+			{
+				return eytzingerSearch(val, [this](const T& element, const T& key) { return mCompare(element, key); });
+			}
+			else
+			{
+				return flatSearch(val, [this](const T& element, const T& key) { return mCompare(element, key); });
+			}
+		}
+
+		// Index of the first element greater than val
+		size_t upper_bound(const T& val) const
+		{
+			if constexpr(std::is_same_v<Layout, EytzingerLayout>)
+			{
+				return eytzingerSearch(val, [this](const T& element, const T& key) { return !mCompare(key, element); });
+			}
+			else
+			{
+				return flatSearch(val, [this](const T& element, const T& key) { return !mCompare(key, element); });
+			}
+		}
+
+		// [lower_bound, upper_bound)
+		std::pair<size_t, size_t> equal_range(const T& val) const
+		{
+			return std::make_pair(lower_bound(val), upper_bound(val));
+		}
+
+		// Index of the first element equal to val, or size() if there is none
+		size_t find(const T& val) const
+		{
+			size_t index = lower_bound(val);
+			return (index != size() && !mCompare(val, mContents[index])) ? index : size();
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != size();
+		}
+
+		size_t count(const T& val) const
+		{
+			std::pair<size_t, size_t> range = equal_range(val);
+			return range.second - range.first;
+		}
+
+		/**
+		 * Bring the search layout up to date now instead of on the next search. Nothing to do for FlatLayout.
+		 */
+		void rebuild() const
+		{
+			if constexpr(std::is_same_v<Layout, EytzingerLayout>)
+			{
+				if(mDirty)
+				{
+					buildEytzinger();
+				}
+			}
+		}
+
+		friend bool operator==(const SortedArrayList& left, const SortedArrayList& right)
+		{
+			return left.mContents == right.mContents;
+		}
+
+		friend bool operator!=(const SortedArrayList& left, const SortedArrayList& right)
+		{
+			return !(left == right);
+		}
+
+	private:
+		/**
+		 * Branchless binary search for the first element where goesLeft(element, val) is false. The range halves
+		 * every step and the only decision is which half to keep, which compiles to a conditional move. Both
+		 * possible next probes get prefetched so big arrays don't stall on every step.
+		 */
+		template<typename GoesLeft>
+		size_t flatSearch(const T& val, GoesLeft goesLeft) const
+		{
+			const T* first = mContents.data();
+			size_t length = mContents.size();
+
+			if(length == 0)
+			{
+				return 0;
+			}
+
+			const T* base = first;
+			while(length > 1)
+			{
+				size_t half = length / 2;
+				detail::prefetch(base + half / 2);
+				detail::prefetch(base + half + half / 2);
+				base = goesLeft(base[half], val) ? base + half : base;
+				length -= half;
+			}
+
+			return static_cast<size_t>(base - first) + (goesLeft(*base, val) ? 1 : 0);
+		}
+
+		/**
+		 * Walk down the BFS ordered tree taking the right child whenever goesLeft(element, val). The path taken is
+		 * encoded in the bits of k, the answer is the last node where we went left, which is k with the trailing
+		 * ones (right turns) and one more bit shifted off.
+		 */
+		template<typename GoesLeft>
+		size_t eytzingerSearch(const T& val, GoesLeft goesLeft) const
+		{
+			rebuild();
+
+			const size_t length = mContents.size();
+			const T* tree = mTree.data();
+
+			size_t k = 1;
+			while(k <= length)
+			{
+				// 16 levels down from here is 4 levels of the tree, those children sit next to each other
+				detail::prefetch(tree + std::min(k * 16, length));
+				k = 2 * k + (goesLeft(tree[k], val) ? 1 : 0);
+			}
+
+			k >>= std::countr_one(k) + 1;
+			return (k == 0) ? length : mRank[k];
+		}
+
+		// In-order walk of the implicit tree, handing out the sorted elements one after another
+		size_t fillEytzinger(size_t sorted, size_t k) const
+		{
+			if(k <= mContents.size())
+			{
+				sorted = fillEytzinger(sorted, 2 * k);
+				mTree[k] = mContents[sorted];
+				mRank[k] = sorted;
+				sorted = fillEytzinger(sorted + 1, 2 * k + 1);
+			}
+
+			return sorted;
+		}
+
+		void buildEytzinger() const
+		{
+			// Slot 0 is unused so the children of k are simply 2k and 2k + 1
+			size_t length = mContents.size();
+			mTree.clear();
+			mRank.clear();
+
+			if(length != 0)
+			{
+				mTree.reserve(length + 1);
+				mRank.reserve(length + 1);
+				for(size_t i = 0; i <= length; ++i)
+				{
+					mTree.push_back(mContents[0]);
+					mRank.push_back(0);
+				}
+
+				fillEytzinger(0, 1);
+			}
+
+			mDirty = false;
+		}
+
+		ArrayList<T, Allocator> mContents;
+		[[no_unique_address]] Compare mCompare;
+
+		// Only used by EytzingerLayout
+		mutable ArrayList<T, Allocator> mTree;
+		mutable ArrayList<size_t> mRank;
+		mutable bool mDirty = true;
+};
+
+#endif /* INCLUDE_SORTEDARRAYLIST_HPP_ */
@@ -0,0 +1,266 @@
+#ifndef INCLUDE_THREADPOOL_HPP_
+#define INCLUDE_THREADPOOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed size thread pool where every worker has its own task deque.
+ *
+ * A worker pushes and pops its own tasks at the back (LIFO, the most recently split work is still in cache) and
+ * when it runs dry steals from the front of someone else's deque (the oldest and usually biggest piece of work).
+ * Tasks submitted from outside the pool are dealt out round robin.
+ *
+ * Each deque has its own small mutex. Workers only touch another deque when they steal, so in steady state those
+ * locks are uncontended.
+ */
+class WorkStealingPool
+{
+	public:
+		explicit WorkStealingPool(std::size_t threadCount = defaultThreadCount())
+		{
+			threadCount = std::max<std::size_t>(threadCount, 1);
+
+			for(std::size_t i = 0; i < threadCount; ++i)
+			{
+				mQueues.push_back(std::make_unique<Queue>());
+			}
+
+			for(std::size_t i = 0; i < threadCount; ++i)
+			{
+				mThreads.emplace_back([this, i] { workerLoop(i); });
+			}
+		}
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		// Runs whatever is still queued, then joins the workers
+		~WorkStealingPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mSleepMutex);
+				mStop = true;
+			}
+
+			mWake.notify_all();
+
+			for(std::thread& thread : mThreads)
+			{
+				thread.join();
+			}
+		}
+
+		// Pool shared by everything that doesn't bring its own
+		static WorkStealingPool& instance()
+		{
+			static WorkStealingPool pool;
+			return pool;
+		}
+
+		static std::size_t defaultThreadCount() noexcept
+		{
+			return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+		}
+
+		std::size_t size() const noexcept
+		{
+			return mThreads.size();
+		}
+
+		void submit(std::function<void()> task)
+		{
+			std::size_t index = (tPool == this) ? tIndex : mNextQueue.fetch_add(1, std::memory_order_relaxed) % size();
+
+			{
+				std::lock_guard<std::mutex> lock(mQueues[index]->mutex);
+				mQueues[index]->tasks.push_back(std::move(task));
+			}
+
+			{
+				// Taking the lock means a worker can't miss the update between checking mPending and going to sleep
+				std::lock_guard<std::mutex> lock(mSleepMutex);
+				mPending.fetch_add(1, std::memory_order_release);
+			}
+
+			mWake.notify_one();
+		}
+
+		/**
+		 * Run one queued task on the calling thread if there is one. Lets a thread that is waiting on tasks help out
+		 * instead of blocking, which also keeps nested parallelism from deadlocking.
+		 */
+		bool runPendingTask()
+		{
+			std::size_t home = (tPool == this) ? tIndex : mNextQueue.load(std::memory_order_relaxed) % size();
+
+			std::function<void()> task;
+			if(!takeTask(home, task))
+			{
+				return false;
+			}
+
+			task();
+			return true;
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		bool takeTask(std::size_t home, std::function<void()>& task)
+		{
+			// Own work first, newest end
+			{
+				std::lock_guard<std::mutex> lock(mQueues[home]->mutex);
+				if(!mQueues[home]->tasks.empty())
+				{
+					task = std::move(mQueues[home]->tasks.back());
+					mQueues[home]->tasks.pop_back();
+					mPending.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+
+			// Then steal the oldest task from everyone else, starting with our neighbour
+			for(std::size_t offset = 1; offset < mQueues.size(); ++offset)
+			{
+				Queue& victim = *mQueues[(home + offset) % mQueues.size()];
+
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if(!victim.tasks.empty())
+				{
+					task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+					mPending.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void workerLoop(std::size_t index)
+		{
+			tPool = this;
+			tIndex = index;
+
+			while(true)
+			{
+				std::function<void()> task;
+				if(takeTask(index, task))
+				{
+					task();
+					continue;
+				}
+
+				std::unique_lock<std::mutex> lock(mSleepMutex);
+				mWake.wait(lock, [this] { return mStop || mPending.load(std::memory_order_acquire) != 0; });
+
+				if(mStop && mPending.load(std::memory_order_acquire) == 0)
+				{
+					return;
+				}
+			}
+		}
+
+		std::vector<std::unique_ptr<Queue>> mQueues;
+		std::vector<std::thread> mThreads;
+
+		std::mutex mSleepMutex;
+		std::condition_variable mWake;
+		std::atomic<std::size_t> mPending{0};
+		std::atomic<std::size_t> mNextQueue{0};
+		bool mStop = false;
+
+		// Which pool (if any) the current thread works for and its queue in that pool
+		static inline thread_local WorkStealingPool* tPool = nullptr;
+		static inline thread_local std::size_t tIndex = 0;
+};
+
+/**
+ * A batch of tasks on a pool that can be waited for as a whole. wait() runs queued tasks on the calling thread while
+ * it waits and rethrows the first exception any of the tasks threw.
+ */
+class TaskGroup
+{
+	public:
+		explicit TaskGroup(WorkStealingPool& pool = WorkStealingPool::instance()) noexcept
+			: mPool(pool)
+		{
+		}
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		~TaskGroup()
+		{
+			waitForTasks();
+		}
+
+		template<typename Function>
+		void run(Function&& function)
+		{
+			mOutstanding.fetch_add(1, std::memory_order_relaxed);
+
+			mPool.submit([this, function = std::forward<Function>(function)]() mutable
+			{
+				try
+				{
+					function();
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> lock(mErrorMutex);
+					if(!mError)
+					{
+						mError = std::current_exception();
+					}
+				}
+
+				mOutstanding.fetch_sub(1, std::memory_order_release);
+			});
+		}
+
+		void wait()
+		{
+			waitForTasks();
+
+			if(mError)
+			{
+				std::rethrow_exception(std::exchange(mError, nullptr));
+			}
+		}
+
+	private:
+		void waitForTasks() noexcept
+		{
+			while(mOutstanding.load(std::memory_order_acquire) != 0)
+			{
+				if(!mPool.runPendingTask())
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		WorkStealingPool& mPool;
+		std::atomic<std::size_t> mOutstanding{0};
+		std::mutex mErrorMutex;
+		std::exception_ptr mError;
+};
+
+#endif /* INCLUDE_THREADPOOL_HPP_ */
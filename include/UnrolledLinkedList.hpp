@@ -0,0 +1,765 @@
+#ifndef INCLUDE_UNROLLEDLINKEDLIST_HPP_
+#define INCLUDE_UNROLLEDLINKEDLIST_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "Relocatable.hpp"
+#include "SimdSearch.hpp"
+
+namespace detail
+{
+	// Most x86 and ARM cores use 64 byte lines. std::hardware_destructive_interference_size would be the portable
+	// spelling but GCC warns that it changes with -mtune.
+	static constexpr std::size_t CACHE_LINE_BYTES = 64;
+}
+
+/**
+ * Linked list of small arrays. Every node holds up to NODE_CAPACITY elements and is CacheLines cache lines big,
+ * so walking the list touches a new line every few elements instead of on every element like LinkedList.
+ *
+ * Access:  O(n / K) (walks node by node, K = NODE_CAPACITY)
+ * Insert:  O(n / K + K) (walk to the node, shift inside it)
+ * Removal: O(n / K + K)
+ * Add:     O(1) at the front and the back (pop_back() walks to the node before the tail, O(n / K))
+ *
+ * Inserting into a full node splits it in two halves. When an erase leaves a node small enough to fit together with
+ * a neighbour the two are merged, so nodes stay at least half full on average.
+ *
+ * Elements are shifted inside a node by relocation (see Relocatable.hpp), so T has to be trivially relocatable or
+ * nothrow movable. Every insert and erase invalidates iterators.
+ */
+template<typename T, typename Allocator = std::allocator<T>, std::size_t CacheLines = 1>
+class UnrolledLinkedList
+{
+	static_assert(detail::is_relocatable_v<T>, "UnrolledLinkedList shifts elements by relocation, T needs a nothrow move");
+
+	struct NodeHeader
+	{
+		void*       next;
+		std::size_t count;
+	};
+
+	public:
+		// As many elements as fit next to the header, but at least 4 or the list degrades into a plain linked list
+		static constexpr std::size_t NODE_CAPACITY = std::max<std::size_t>(
+			(CacheLines * detail::CACHE_LINE_BYTES - sizeof(NodeHeader)) / sizeof(T), 4);
+
+	private:
+		struct alignas(detail::CACHE_LINE_BYTES) Node
+		{
+			Node*       next = nullptr;
+			std::size_t count = 0;
+			alignas(T) unsigned char storage[NODE_CAPACITY * sizeof(T)];
+
+			T* elements() noexcept
+			{
+				return std::launder(reinterpret_cast<T*>(storage));
+			}
+
+			const T* elements() const noexcept
+			{
+				return std::launder(reinterpret_cast<const T*>(storage));
+			}
+
+			bool full() const noexcept
+			{
+				return count == NODE_CAPACITY;
+			}
+		};
+
+		using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+		using NodeTraits    = std::allocator_traits<NodeAllocator>;
+		using AllocTraits   = std::allocator_traits<Allocator>;
+
+		template<bool Const>
+		class Iterator;
+
+	public:
+		using value_type      = T;
+		using allocator_type  = Allocator;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference       = T&;
+		using const_reference = const T&;
+		using iterator        = Iterator<false>;
+		using const_iterator  = Iterator<true>;
+
+		UnrolledLinkedList() = default;
+
+		explicit UnrolledLinkedList(const Allocator& allocator) noexcept
+			: mAllocator(allocator), mElementAllocator(allocator)
+		{
+		}
+
+		UnrolledLinkedList(const std::initializer_list<T>& il, const Allocator& allocator = Allocator())
+			: mAllocator(allocator), mElementAllocator(allocator)
+		{
+			for(const T& val : il)
+			{
+				push_back(val);
+			}
+		}
+
+		UnrolledLinkedList(const UnrolledLinkedList& other)
+			: mAllocator(NodeTraits::select_on_container_copy_construction(other.mAllocator)),
+			  mElementAllocator(mAllocator)
+		{
+			try
+			{
+				for(const T& val : other)
+				{
+					push_back(val);
+				}
+			}
+			catch(...)
+			{
+				release();
+				throw;
+			}
+		}
+
+		UnrolledLinkedList(UnrolledLinkedList&& other) noexcept
+			: mAllocator(std::move(other.mAllocator)), mElementAllocator(mAllocator)
+		{
+			swapNodes(*this, other);
+		}
+
+		// Copy assignment. The copy is built with our own allocator (or other's, if it propagates on copy assignment)
+		// and only replaces the current nodes once it's complete.
+		UnrolledLinkedList& operator=(const UnrolledLinkedList& other)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			if constexpr(NodeTraits::propagate_on_container_copy_assignment::value)
+			{
+				if constexpr(!NodeTraits::is_always_equal::value)
+				{
+					if(mAllocator != other.mAllocator)
+					{
+						release();
+					}
+				}
+
+				mAllocator = other.mAllocator;
+				mElementAllocator = other.mElementAllocator;
+			}
+
+			UnrolledLinkedList temp(mElementAllocator);
+			for(const T& val : other)
+			{
+				temp.push_back(val);
+			}
+
+			swapNodes(*this, temp);
+			return *this;
+		}
+
+		// Move assignment. Nodes belong to the allocator that made them, so when the allocators differ and don't
+		// propagate the elements have to be moved into new nodes one by one.
+		UnrolledLinkedList& operator=(UnrolledLinkedList&& other) noexcept(
+			NodeTraits::propagate_on_container_move_assignment::value || NodeTraits::is_always_equal::value)
+		{
+			if(this == &other)
+			{
+				return *this;
+			}
+
+			release();
+
+			if constexpr(NodeTraits::propagate_on_container_move_assignment::value)
+			{
+				mAllocator = std::move(other.mAllocator);
+				mElementAllocator = std::move(other.mElementAllocator);
+			}
+			else if constexpr(!NodeTraits::is_always_equal::value)
+			{
+				if(mAllocator != other.mAllocator)
+				{
+					for(T& val : other)
+					{
+						push_back(std::move(val));
+					}
+
+					other.release();
+					return *this;
+				}
+			}
+
+			swapNodes(*this, other);
+			return *this;
+		}
+
+		virtual ~UnrolledLinkedList()
+		{
+			release();
+		}
+
+		// Like the standard containers, the allocators have to propagate on swap or compare equal
+		friend void swap(UnrolledLinkedList& left, UnrolledLinkedList& right) noexcept
+		{
+			using std::swap;
+
+			swapNodes(left, right);
+
+			if constexpr(NodeTraits::propagate_on_container_swap::value)
+			{
+				swap(left.mAllocator, right.mAllocator);
+				swap(left.mElementAllocator, right.mElementAllocator);
+			}
+		}
+
+		allocator_type get_allocator() const noexcept
+		{
+			return allocator_type(mAllocator);
+		}
+
+		// Iterators:
+
+		iterator begin() noexcept
+		{
+			return iterator(mHead, 0);
+		}
+
+		const_iterator begin() const noexcept
+		{
+			return const_iterator(mHead, 0);
+		}
+
+		const_iterator cbegin() const noexcept
+		{
+			return begin();
+		}
+
+		iterator end() noexcept
+		{
+			return iterator(nullptr, 0);
+		}
+
+		const_iterator end() const noexcept
+		{
+			return const_iterator(nullptr, 0);
+		}
+
+		const_iterator cend() const noexcept
+		{
+			return end();
+		}
+
+		// Capacity:
+		size_t size() const noexcept
+		{
+			return mCurrentSize;
+		}
+
+		size_t max_size() const noexcept
+		{
+			return NodeTraits::max_size(mAllocator) * NODE_CAPACITY;
+		}
+
+		bool empty() const noexcept
+		{
+			return mCurrentSize == 0;
+		}
+
+		// Number of nodes, to keep an eye on how well they are filled
+		size_t node_count() const noexcept
+		{
+			return mNodeCount;
+		}
+
+		// Element access:
+
+		T& operator[] (size_t index) // throw out_of_range
+		{
+			return at(index);
+		}
+
+		const T& operator[] (size_t index) const // throw out_of_range
+		{
+			return at(index);
+		}
+
+		T& at(size_t index) // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const UnrolledLinkedList*>(this)->at(index));
+		}
+
+		const T& at(size_t index) const // throw out_of_range
+		{
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			Position position = locate(index);
+			return position.node->elements()[position.offset];
+		}
+
+		T& front() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const UnrolledLinkedList*>(this)->front());
+		}
+
+		const T& front() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mHead->elements()[0];
+		}
+
+		T& back() // throw out_of_range
+		{
+			return const_cast<T&>(static_cast<const UnrolledLinkedList*>(this)->back());
+		}
+
+		const T& back() const // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			return mTail->elements()[mTail->count - 1];
+		}
+
+		// Modifiers
+
+		void push_front(const T& val)
+		{
+			emplaceAt(0, val);
+		}
+
+		void push_front(T&& val)
+		{
+			emplaceAt(0, std::move(val));
+		}
+
+		void push_back(const T& val)
+		{
+			emplaceAt(mCurrentSize, val);
+		}
+
+		void push_back(T&& val)
+		{
+			emplaceAt(mCurrentSize, std::move(val));
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args)
+		{
+			return emplaceAt(mCurrentSize, std::forward<Args>(args)...);
+		}
+
+		template<typename... Args>
+		T& emplace(std::size_t insertIndex, Args&&... args) // throw out_of_range
+		{
+			return emplaceAt(insertIndex, std::forward<Args>(args)...);
+		}
+
+		void insert(const T& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, val);
+		}
+
+		void insert(T&& val, std::size_t insertIndex) // throw out_of_range
+		{
+			emplaceAt(insertIndex, std::move(val));
+		}
+
+		void replace(const T& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = val;
+		}
+
+		void replace(T&& val, std::size_t index) // throw out_of_range
+		{
+			at(index) = std::move(val);
+		}
+
+		T pop_front()
+		{
+			return erase(0);
+		}
+
+		T pop_back()
+		{
+			return erase(mCurrentSize - 1);
+		}
+
+		T erase(std::size_t index) // throw out_of_range
+		{
+			if(empty())
+			{
+				throw std::out_of_range("Empty list");
+			}
+
+			if(index >= mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			Position position = locate(index);
+			Node* node = position.node;
+			T* elements = node->elements();
+
+			T removed = std::move(elements[position.offset]);
+			AllocTraits::destroy(mElementAllocator, elements + position.offset);
+			detail::relocate(mElementAllocator, elements + position.offset + 1, elements + node->count,
+			                 elements + position.offset);
+			node->count--;
+			mCurrentSize--;
+
+			rebalance(position.prev, node);
+			return removed;
+		}
+
+		void remove(const T& val)
+		{
+			size_t index = find(val);
+			if(index != mCurrentSize)
+			{
+				erase(index);
+			}
+		}
+
+		/**
+		 * Return index of the first element equal to val, or size() if there is none. Each node is a contiguous run
+		 * so 32/64 bit integers, float and double are searched with SIMD (see SimdSearch.hpp).
+		 */
+		size_t find(const T& val) const
+		{
+			size_t index = 0;
+			for(const Node* node = mHead; node != nullptr; node = node->next)
+			{
+				size_t found = findIn(node->elements(), node->count, val);
+				if(found != node->count)
+				{
+					return index + found;
+				}
+
+				index += node->count;
+			}
+
+			return mCurrentSize;
+		}
+
+		bool contains(const T& val) const
+		{
+			return find(val) != mCurrentSize;
+		}
+
+		void clear() noexcept
+		{
+			release();
+		}
+
+	private:
+		struct Position
+		{
+			Node*  prev;
+			Node*  node;
+			size_t offset;
+		};
+
+		static size_t findIn(const T* elements, size_t count, const T& val)
+		{
+			if constexpr(simd::is_searchable_v<T>)
+			{
+				return simd::find(elements, count, val);
+			}
+			else
+			{
+				return static_cast<size_t>(std::find(elements, elements + count, val) - elements);
+			}
+		}
+
+		static void swapNodes(UnrolledLinkedList& left, UnrolledLinkedList& right) noexcept
+		{
+			std::swap(left.mHead, right.mHead);
+			std::swap(left.mTail, right.mTail);
+			std::swap(left.mCurrentSize, right.mCurrentSize);
+			std::swap(left.mNodeCount, right.mNodeCount);
+		}
+
+		// Node holding element index and the node before it. Only called with index < size().
+		Position locate(size_t index) const noexcept
+		{
+			Node* prev = nullptr;
+			Node* node = mHead;
+			while(index >= node->count)
+			{
+				index -= node->count;
+				prev = node;
+				node = node->next;
+			}
+
+			return Position{prev, node, index};
+		}
+
+		Node* createNode()
+		{
+			Node* node = NodeTraits::allocate(mAllocator, 1);
+			NodeTraits::construct(mAllocator, node);
+			mNodeCount++;
+			return node;
+		}
+
+		void destroyNode(Node* node) noexcept
+		{
+			NodeTraits::destroy(mAllocator, node);
+			NodeTraits::deallocate(mAllocator, node, 1);
+			mNodeCount--;
+		}
+
+		// Link node in after prev, or at the head when prev is nullptr
+		void linkAfter(Node* prev, Node* node) noexcept
+		{
+			Node*& link = (prev == nullptr) ? mHead : prev->next;
+			node->next = link;
+			link = node;
+
+			if(node->next == nullptr)
+			{
+				mTail = node;
+			}
+		}
+
+		void unlink(Node* prev, Node* node) noexcept
+		{
+			((prev == nullptr) ? mHead : prev->next) = node->next;
+
+			if(node == mTail)
+			{
+				mTail = prev;
+			}
+		}
+
+		template<typename... Args>
+		T& emplaceAt(std::size_t insertIndex, Args&&... args)
+		{
+			if(insertIndex > mCurrentSize)
+			{
+				throw std::out_of_range("Index out of bounds");
+			}
+
+			// args could be one of our elements, which might move before we construct
+			T temp(std::forward<Args>(args)...);
+
+			Node* node = nullptr;
+			size_t offset = 0;
+
+			if(insertIndex == mCurrentSize)
+			{
+				// Appending: fill up the tail, a full tail gets a fresh node rather than a split so a list built by
+				// push_back ends up with completely full nodes
+				if(mTail == nullptr || mTail->full())
+				{
+					linkAfter(mTail, createNode());
+				}
+
+				node = mTail;
+				offset = node->count;
+			}
+			else
+			{
+				Position position = locate(insertIndex);
+				node = position.node;
+				offset = position.offset;
+
+				if(node->full())
+				{
+					// Split: the upper half moves to a new node right after this one
+					Node* upper = createNode();
+					size_t half = NODE_CAPACITY / 2;
+					detail::relocate(mElementAllocator, node->elements() + half, node->elements() + NODE_CAPACITY,
+					                 upper->elements());
+					upper->count = NODE_CAPACITY - half;
+					node->count = half;
+					linkAfter(node, upper);
+
+					if(offset > half)
+					{
+						node = upper;
+						offset -= half;
+					}
+				}
+			}
+
+			T* elements = node->elements();
+			detail::relocate(mElementAllocator, elements + offset, elements + node->count, elements + offset + 1);
+			AllocTraits::construct(mElementAllocator, elements + offset, std::move(temp));
+			node->count++;
+			mCurrentSize++;
+
+			return elements[offset];
+		}
+
+		/**
+		 * After node lost an element: drop it if it's empty, otherwise merge it with a neighbour when the two fit in
+		 * one node together.
+		 */
+		void rebalance(Node* prev, Node* node) noexcept
+		{
+			if(node->count == 0)
+			{
+				unlink(prev, node);
+				destroyNode(node);
+				return;
+			}
+
+			if(node->count >= NODE_CAPACITY / 2)
+			{
+				return;
+			}
+
+			if(node->next != nullptr && node->count + node->next->count <= NODE_CAPACITY)
+			{
+				mergeNext(node);
+			}
+			else if(prev != nullptr && prev->count + node->count <= NODE_CAPACITY)
+			{
+				mergeNext(prev);
+			}
+		}
+
+		// Move everything from node->next to the end of node and drop node->next
+		void mergeNext(Node* node) noexcept
+		{
+			Node* next = node->next;
+			detail::relocate(mElementAllocator, next->elements(), next->elements() + next->count,
+			                 node->elements() + node->count);
+			node->count += next->count;
+			next->count = 0;
+			unlink(node, next);
+			destroyNode(next);
+		}
+
+		void release() noexcept
+		{
+			Node* node = mHead;
+			while(node != nullptr)
+			{
+				Node* next = node->next;
+				for(size_t i = 0; i < node->count; ++i)
+				{
+					AllocTraits::destroy(mElementAllocator, node->elements() + i);
+				}
+
+				destroyNode(node);
+				node = next;
+			}
+
+			mHead = nullptr;
+			mTail = nullptr;
+			mCurrentSize = 0;
+		}
+
+		Node*  mHead = nullptr;
+		Node*  mTail = nullptr;
+		size_t mCurrentSize = 0;
+		size_t mNodeCount = 0;
+		[[no_unique_address]] NodeAllocator mAllocator;
+		// Only used to construct and destroy elements in place, never allocates
+		[[no_unique_address]] Allocator mElementAllocator;
+};
+
+/**
+ * Forward iterator over an UnrolledLinkedList: the current node and the position inside it.
+ */
+template<typename T, typename Allocator, std::size_t CacheLines>
+template<bool Const>
+class UnrolledLinkedList<T, Allocator, CacheLines>::Iterator
+{
+	using NodePointer = std::conditional_t<Const, const Node*, Node*>;
+
+	public:
+		using value_type        = T;
+		using pointer           = std::conditional_t<Const, const T*, T*>;
+		using reference         = std::conditional_t<Const, const T&, T&>;
+		using difference_type   = std::ptrdiff_t;
+		using iterator_category = std::forward_iterator_tag;
+
+		Iterator() = default;
+
+		Iterator(NodePointer node, std::size_t offset) noexcept
+			: mNode(node), mOffset(offset)
+		{
+		}
+
+		// iterator -> const_iterator
+		template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+		Iterator(const Iterator<OtherConst>& other) noexcept
+			: mNode(other.mNode), mOffset(other.mOffset)
+		{
+		}
+
+		reference operator*() const noexcept
+		{
+			return mNode->elements()[mOffset];
+		}
+
+		pointer operator->() const noexcept
+		{
+			return mNode->elements() + mOffset;
+		}
+
+		Iterator& operator++() noexcept
+		{
+			if(++mOffset == mNode->count)
+			{
+				mNode = mNode->next;
+				mOffset = 0;
+			}
+
+			return *this;
+		}
+
+		Iterator operator++(int) noexcept
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		friend bool operator==(const Iterator& left, const Iterator& right) noexcept
+		{
+			return left.mNode == right.mNode && left.mOffset == right.mOffset;
+		}
+
+	private:
+		template<bool>
+		friend class Iterator;
+
+		NodePointer mNode = nullptr;
+		std::size_t mOffset = 0;
+};
+
+template<typename T, typename Allocator, std::size_t CacheLines>
+inline bool operator==(const UnrolledLinkedList<T, Allocator, CacheLines>& left,
+                       const UnrolledLinkedList<T, Allocator, CacheLines>& right)
+{
+	return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
+}
+
+template<typename T, typename Allocator, std::size_t CacheLines>
+inline bool operator!=(const UnrolledLinkedList<T, Allocator, CacheLines>& left,
+                       const UnrolledLinkedList<T, Allocator, CacheLines>& right)
+{
+	return !operator==(left, right);
+}
+
+#endif /* INCLUDE_UNROLLEDLINKEDLIST_HPP_ */
@@ -1,6 +1,150 @@
 #include "../include/ArrayList.hpp"
+#include "TrackingResource.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Counts live objects so we can tell which slots of the buffer are actually constructed.
+	struct Tracked
+	{
+		static int alive;
+
+		Tracked(int v = 0) : value(v) { ++alive; }
+		Tracked(const Tracked& other) : value(other.value) { ++alive; }
+		Tracked(Tracked&& other) noexcept : value(other.value) { ++alive; }
+		Tracked& operator=(const Tracked&) = default;
+		Tracked& operator=(Tracked&&) = default;
+		~Tracked() { --alive; }
+
+		bool operator==(const Tracked& other) const { return value == other.value; }
+		bool operator!=(const Tracked& other) const { return value != other.value; }
+
+		int value;
+	};
+
+	int Tracked::alive = 0;
+
+	// Counts copies so we can tell an rvalue actually got moved
+	struct CopyCounter
+	{
+		static int copies;
+
+		CopyCounter(int v = 0) : value(v) {}
+		CopyCounter(int a, int b) : value(a + b) {}
+		CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+		CopyCounter(CopyCounter&&) noexcept = default;
+		CopyCounter& operator=(const CopyCounter& other) { value = other.value; ++copies; return *this; }
+		CopyCounter& operator=(CopyCounter&&) noexcept = default;
+
+		bool operator==(const CopyCounter& other) const { return value == other.value; }
+
+		int value;
+	};
+
+	int CopyCounter::copies = 0;
+
+	// Opted in to memmove relocation below
+	struct Handle
+	{
+		std::shared_ptr<int> value;
+	};
+
+	// Move can throw (as far as the compiler knows) so it has to be shifted by assignment
+	struct ThrowingMove
+	{
+		ThrowingMove(int v = 0) : value(v) {}
+		ThrowingMove(const ThrowingMove&) = default;
+		ThrowingMove(ThrowingMove&& other) noexcept(false) : value(other.value) {}
+		ThrowingMove& operator=(const ThrowingMove&) = default;
+		ThrowingMove& operator=(ThrowingMove&&) = default;
+
+		int value;
+	};
+
+	// Minimal allocator that records how many allocations are outstanding.
+	template<typename T>
+	struct CountingAllocator
+	{
+		using value_type = T;
+
+		static inline int allocations = 0;
+
+		CountingAllocator() = default;
+
+		template<typename U>
+		CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+		T* allocate(std::size_t n)
+		{
+			++allocations;
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept
+		{
+			--allocations;
+			std::allocator<T>().deallocate(p, n);
+		}
+
+		template<typename U>
+		bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+
+		template<typename U>
+		bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+	};
+
+	template<typename Lane>
+	using FindKernel = std::size_t (*)(const Lane*, std::size_t, Lane) noexcept;
+
+	/**
+	 * Run one find and one count kernel over every size up to a few unrolled iterations of the widest vector, with
+	 * the match in every position. Each size gets a buffer of exactly that many elements so a kernel that reads past
+	 * the end trips the address sanitizer.
+	 */
+	template<typename Lane>
+	void checkKernel(FindKernel<Lane> find, FindKernel<Lane> count)
+	{
+		const Lane hit = Lane(2);
+
+		for(size_t size = 0; size < 72; ++size)
+		{
+			std::vector<Lane> data(size, Lane(1));
+			BOOST_REQUIRE(find(data.data(), size, hit) == size);
+			BOOST_REQUIRE(count(data.data(), size, hit) == 0);
+			BOOST_REQUIRE(count(data.data(), size, Lane(1)) == size);
+
+			for(size_t pos = 0; pos < size; ++pos)
+			{
+				data[pos] = hit;
+				data[size - 1] = hit;
+				size_t expected = (pos == size - 1) ? 1 : 2;
+
+				BOOST_REQUIRE(find(data.data(), size, hit) == pos);
+				BOOST_REQUIRE(count(data.data(), size, hit) == expected);
+
+				data[pos] = Lane(1);
+				data[size - 1] = Lane(1);
+			}
+		}
+	}
+}
+
+template<>
+struct is_trivially_relocatable<Handle> : std::true_type
+{
+};
+
+static_assert(std::contiguous_iterator<ArrayList<int>::iterator>);
+static_assert(std::contiguous_iterator<ArrayList<int>::const_iterator>);
+
 BOOST_AUTO_TEST_SUITE(DataStructures)
 
 BOOST_AUTO_TEST_CASE(DefaultConstructor)
@@ -76,6 +220,31 @@ BOOST_AUTO_TEST_CASE(CopyAssignment)
 	BOOST_CHECK(val == 6);
 }
 
+BOOST_AUTO_TEST_CASE(CopyAssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		ArrayList<int, std::pmr::polymorphic_allocator<int>> testList1({1, 2, 3}, &arena);
+		ArrayList<int, std::pmr::polymorphic_allocator<int>> testList2({4, 5, 6, 7}, &other);
+
+		// polymorphic_allocator doesn't propagate, testList1 keeps drawing from arena
+		testList1 = testList2;
+		BOOST_CHECK(testList1 == testList2);
+		BOOST_CHECK(testList1.get_allocator().resource() == &arena);
+		BOOST_CHECK(arena.outstanding() == 1);
+
+		testList1.push_back(8);
+		BOOST_CHECK(testList1.back() == 8);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
 BOOST_AUTO_TEST_CASE(Front)
 {
 	int temp = 2;
@@ -227,4 +396,417 @@ BOOST_AUTO_TEST_CASE(GreaterThan)
 	BOOST_CHECK(testList1 > testList2);
 }
 
+BOOST_AUTO_TEST_CASE(EmptyDoesNotAllocate)
+{
+	ArrayList<int, CountingAllocator<int>> testList;
+
+	BOOST_CHECK(CountingAllocator<int>::allocations == 0);
+	BOOST_CHECK(testList.capacity() == 0);
+	BOOST_CHECK(testList.data() == nullptr);
+
+	testList.push_back(1);
+	BOOST_CHECK(CountingAllocator<int>::allocations == 1);
+}
+
+BOOST_AUTO_TEST_CASE(OnlyLiveElementsConstructed)
+{
+	{
+		ArrayList<Tracked> testList;
+		testList.push_back(Tracked(1));
+		testList.push_back(Tracked(2));
+		testList.insert(Tracked(0), 0);
+
+		BOOST_CHECK(Tracked::alive == 3);
+		BOOST_CHECK(testList.capacity() > testList.size());
+
+		testList.erase(1);
+		BOOST_CHECK(Tracked::alive == 2);
+		BOOST_CHECK(testList[1].value == 2);
+
+		ArrayList<Tracked> copy = testList;
+		BOOST_CHECK(Tracked::alive == 4);
+	}
+
+	BOOST_CHECK(Tracked::alive == 0);
+}
+
+BOOST_AUTO_TEST_CASE(InsertOwnElement)
+{
+	ArrayList<std::string> testList{"A", "B", "C", "D", "E", "F", "G", "H"};
+	testList.push_back(testList[0]);
+	testList.insert(testList[8], 1);
+
+	BOOST_CHECK(testList.size() == 10);
+	BOOST_CHECK(testList[1] == "A");
+	BOOST_CHECK(testList[9] == "A");
+}
+
+BOOST_AUTO_TEST_CASE(RelocatingInsertErase)
+{
+	ArrayList<Handle> testList;
+	for(int i = 0; i < 10; ++i)
+	{
+		testList.push_back(Handle{std::make_shared<int>(i)});
+	}
+
+	testList.insert(Handle{std::make_shared<int>(100)}, 5);
+	BOOST_CHECK(*testList[5].value == 100);
+	BOOST_CHECK(*testList[6].value == 5);
+
+	testList.erase(0);
+	BOOST_CHECK(*testList[0].value == 1);
+	BOOST_CHECK(*testList[9].value == 9);
+}
+
+BOOST_AUTO_TEST_CASE(ShiftingInsertErase)
+{
+	ArrayList<ThrowingMove> testList;
+	for(int i = 0; i < 10; ++i)
+	{
+		testList.push_back(ThrowingMove(i));
+	}
+
+	testList.insert(ThrowingMove(100), 5);
+	BOOST_CHECK(testList[5].value == 100);
+	BOOST_CHECK(testList[6].value == 5);
+
+	testList.erase(0);
+	BOOST_CHECK(testList[0].value == 1);
+	BOOST_CHECK(testList[9].value == 9);
+}
+
+BOOST_AUTO_TEST_CASE(ReserveAndShrinkToFit)
+{
+	ArrayList<int> testList;
+	testList.reserve(100);
+	BOOST_CHECK(testList.capacity() == 100);
+
+	const int* before = testList.data();
+	for(int i = 0; i < 100; ++i)
+	{
+		testList.push_back(i);
+	}
+	BOOST_CHECK(testList.data() == before);
+
+	testList.reserve(10);
+	BOOST_CHECK(testList.capacity() == 100);
+
+	testList.push_back(100);
+	testList.shrink_to_fit();
+	BOOST_CHECK(testList.capacity() == testList.size());
+	BOOST_CHECK(testList.back() == 100);
+
+	ArrayList<int> emptyList{1};
+	emptyList.pop_back();
+	emptyList.shrink_to_fit();
+	BOOST_CHECK(emptyList.capacity() == 0);
+	BOOST_CHECK(emptyList.data() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(NoThrashAtBoundary)
+{
+	ArrayList<int> testList;
+	for(int i = 0; i < 16; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	testList.push_back(16);
+	testList.pop_back();
+
+	size_t capacity = testList.capacity();
+	for(int i = 0; i < 100; ++i)
+	{
+		testList.push_back(i);
+		testList.pop_back();
+	}
+
+	BOOST_CHECK(testList.capacity() == capacity);
+}
+
+BOOST_AUTO_TEST_CASE(NeverShrinkPolicy)
+{
+	ArrayList<int, std::allocator<int>, NeverShrink<>> testList;
+	for(int i = 0; i < 1000; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	size_t capacity = testList.capacity();
+	while(!testList.empty())
+	{
+		testList.pop_back();
+	}
+
+	BOOST_CHECK(testList.capacity() == capacity);
+}
+
+BOOST_AUTO_TEST_CASE(GrowthPolicies)
+{
+	BOOST_CHECK(DoublingGrowth::grow(0, 1, 4) == 8);
+	BOOST_CHECK(DoublingGrowth::grow(8, 9, 4) == 16);
+	BOOST_CHECK(OneAndHalfGrowth::grow(16, 17, 4) == 24);
+	BOOST_CHECK(FixedChunkGrowth<10>::grow(20, 21, 4) == 30);
+	BOOST_CHECK(FixedChunkGrowth<10>::shrink(100, 5, 4) == 20);
+
+	// 8 * 24 = 192 bytes is already a size class, 16 * 36 = 576 bytes rounds up to the 640 byte class
+	BOOST_CHECK(SizeClassGrowth::grow(0, 1, 24) == 8);
+	BOOST_CHECK(SizeClassGrowth::grow(8, 9, 36) == 17);
+
+	ArrayList<int, std::allocator<int>, OneAndHalfGrowth> testList;
+	for(int i = 0; i < 100; ++i)
+	{
+		testList.push_back(i);
+	}
+	BOOST_CHECK(testList[99] == 99);
+}
+
+BOOST_AUTO_TEST_CASE(Iterators)
+{
+	ArrayList<int> testList {3, 1, 2};
+	std::sort(testList.begin(), testList.end());
+
+	int val = 0;
+	for(int& element : testList)
+	{
+		val = val * 10 + element;
+	}
+	BOOST_CHECK(val == 123);
+
+	std::string reversed;
+	for(auto it = testList.crbegin(); it != testList.crend(); ++it)
+	{
+		reversed += std::to_string(*it);
+	}
+	BOOST_CHECK(reversed == "321");
+
+	ArrayList<int>::const_iterator first = testList.begin();
+	BOOST_CHECK(first == testList.cbegin());
+	BOOST_CHECK(testList.end() - first == 3);
+	BOOST_CHECK(std::to_address(first) == testList.data());
+	BOOST_CHECK(std::find(testList.begin(), testList.end(), 2) == testList.begin() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(Instrumentation)
+{
+	using CountedList = ArrayList<int, std::allocator<int>, DoublingGrowth, CountingInstrumentation>;
+
+	CountedList testList;
+	for(int i = 0; i < 9; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	BOOST_CHECK(testList.stats().constructions == 1);
+	BOOST_CHECK(testList.stats().reallocations == 2);
+	BOOST_CHECK(testList.stats().bytesCopied == 8 * sizeof(int));
+
+	CountedList copy = testList;
+	BOOST_CHECK(copy.stats().copies == 1);
+	BOOST_CHECK(copy.stats().bytesCopied == 9 * sizeof(int));
+
+	CountedList moved = std::move(copy);
+	BOOST_CHECK(moved.stats().moves == 1);
+	BOOST_CHECK(moved.stats().copies == 0);
+
+	BOOST_CHECK(ArrayList<int>().stats().copies == 0);
+	BOOST_CHECK(sizeof(ArrayList<int>) == sizeof(CountedList) - sizeof(ContainerStats));
+}
+
+BOOST_AUTO_TEST_CASE(Emplace)
+{
+	ArrayList<std::unique_ptr<int>> testList;
+	testList.push_back(std::make_unique<int>(1));
+	testList.emplace_back(new int(2));
+	testList.emplace(0, new int(0));
+	testList.push_front(std::make_unique<int>(-1));
+	testList.replace(std::make_unique<int>(3), 3);
+
+	BOOST_CHECK(*testList[0] == -1);
+	BOOST_CHECK(*testList[1] == 0);
+	BOOST_CHECK(*testList[2] == 1);
+	BOOST_CHECK(*testList[3] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(RvaluesMove)
+{
+	CopyCounter::copies = 0;
+
+	ArrayList<CopyCounter> testList;
+	for(int i = 0; i < 20; ++i)
+	{
+		testList.push_back(CopyCounter(i));
+		testList.push_front(CopyCounter(i));
+		testList.insert(CopyCounter(i), 1);
+		testList.emplace_back(i, i);
+	}
+	testList.replace(CopyCounter(5), 0);
+
+	BOOST_CHECK(CopyCounter::copies == 0);
+	BOOST_CHECK(testList.back().value == 38);
+
+	CopyCounter value(7);
+	testList.replace(value, 1);
+	BOOST_CHECK(CopyCounter::copies == 1);
+	BOOST_CHECK(testList[1].value == 7);
+}
+
+BOOST_AUTO_TEST_CASE(Append)
+{
+	std::vector<int> values(100);
+	std::iota(values.begin(), values.end(), 0);
+
+	ArrayList<int, std::allocator<int>, DoublingGrowth, CountingInstrumentation> testList;
+	testList.push_back(-1);
+	testList.append(values.begin(), values.end());
+	testList.append(std::span<const int>(values.data(), 10));
+
+	BOOST_CHECK(testList.size() == 111);
+	BOOST_CHECK(testList[100] == 99);
+	BOOST_CHECK(testList[110] == 9);
+	BOOST_CHECK(testList.stats().reallocations == 3);
+
+	// Appending ourselves has to copy out before the buffer moves
+	testList.append(testList);
+	BOOST_CHECK(testList.size() == 222);
+	BOOST_CHECK(testList[111] == -1);
+	BOOST_CHECK(testList[221] == 9);
+}
+
+BOOST_AUTO_TEST_CASE(InsertRange)
+{
+	std::vector<std::string> values{"x", "y", "z"};
+
+	ArrayList<std::string> testList{"A", "B", "C", "D", "E"};
+	testList.reserve(20);
+	testList.insert(1, values.begin(), values.end());
+	testList.insert(8, values.begin(), values.begin() + 1);
+	testList.insert(0, testList.begin() + 5, testList.end());
+
+	std::string value;
+	for(const std::string& element : testList)
+	{
+		value += element;
+	}
+	BOOST_CHECK(value == "CDExAxyzBCDEx");
+
+	std::istringstream stream("1 2 3");
+	ArrayList<int> fromStream{0, 4};
+	fromStream.insert(1, std::istream_iterator<int>(stream), std::istream_iterator<int>());
+	BOOST_CHECK(fromStream == ArrayList<int>({0, 1, 2, 3, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(InsertRangeShifting)
+{
+	ArrayList<ThrowingMove> testList;
+	for(int i = 0; i < 5; ++i)
+	{
+		testList.push_back(ThrowingMove(i));
+	}
+
+	std::vector<ThrowingMove> shortRange(2, ThrowingMove(7));
+	std::vector<ThrowingMove> longRange(6, ThrowingMove(9));
+	testList.insert(4, shortRange.begin(), shortRange.end());
+	testList.insert(1, longRange.begin(), longRange.end());
+	testList.insert(0, shortRange.begin(), shortRange.end());
+
+	std::string value;
+	for(const ThrowingMove& element : testList)
+	{
+		value += std::to_string(element.value);
+	}
+	BOOST_CHECK(value == "770999999123774");
+}
+
+BOOST_AUTO_TEST_CASE(Assign)
+{
+	ArrayList<std::string> testList{"A", "B"};
+	testList.assign({"C", "D", "E"});
+	BOOST_CHECK(testList == ArrayList<std::string>({"C", "D", "E"}));
+
+	testList.assign(testList.begin() + 1, testList.end());
+	BOOST_CHECK(testList == ArrayList<std::string>({"D", "E"}));
+
+	std::vector<std::string> values(20, "F");
+	testList.assign(values.begin(), values.end());
+	BOOST_CHECK(testList.size() == 20);
+
+	testList.clear();
+	BOOST_CHECK(testList.empty());
+	BOOST_CHECK(testList.capacity() >= 20);
+}
+
+BOOST_AUTO_TEST_CASE(FindArithmetic)
+{
+	ArrayList<uint64_t> ids;
+	ArrayList<float> floats;
+	for(size_t i = 0; i < 1000; ++i)
+	{
+		ids.push_back(i % 100);
+		floats.push_back(static_cast<float>(i % 10));
+	}
+
+	BOOST_CHECK(ids.find(99) == 99);
+	BOOST_CHECK(ids.find(100) == ids.size());
+	BOOST_CHECK(ids.count(7) == 10);
+	BOOST_CHECK(ids.contains(42));
+	BOOST_CHECK(ids.find_if([](uint64_t id) { return id > 98; }) == 99);
+
+	BOOST_CHECK(floats.find(-0.0f) == 0);
+	BOOST_CHECK(floats.count(9.0f) == 100);
+	BOOST_CHECK(floats.find(std::numeric_limits<float>::quiet_NaN()) == floats.size());
+
+	ArrayList<int32_t> tail {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -5};
+	BOOST_CHECK(tail.find(-5) == 19);
+	BOOST_CHECK(tail.count(0) == 19);
+}
+
+// Dispatch only ever picks the best kernel this machine has, so every ISA gets called directly here
+BOOST_AUTO_TEST_CASE(SimdKernels)
+{
+	using namespace simd::kernels;
+
+	checkKernel<std::uint32_t>(findScalar, countScalar);
+	checkKernel<std::uint64_t>(findScalar, countScalar);
+	checkKernel<float>(findScalar, countScalar);
+	checkKernel<double>(findScalar, countScalar);
+
+#ifdef DATASTRUCTURES_SIMD_X86
+	__builtin_cpu_init();
+
+	if(__builtin_cpu_supports("sse2"))
+	{
+		checkKernel<std::uint32_t>(findSse2, countSse2);
+		checkKernel<std::uint64_t>(findSse2, countSse2);
+		checkKernel<float>(findSse2, countSse2);
+		checkKernel<double>(findSse2, countSse2);
+	}
+
+	if(__builtin_cpu_supports("avx2"))
+	{
+		checkKernel<std::uint32_t>(findAvx2, countAvx2);
+		checkKernel<std::uint64_t>(findAvx2, countAvx2);
+		checkKernel<float>(findAvx2, countAvx2);
+		checkKernel<double>(findAvx2, countAvx2);
+	}
+
+	if(__builtin_cpu_supports("avx512f"))
+	{
+		checkKernel<std::uint32_t>(findAvx512, countAvx512);
+		checkKernel<std::uint64_t>(findAvx512, countAvx512);
+		checkKernel<float>(findAvx512, countAvx512);
+		checkKernel<double>(findAvx512, countAvx512);
+	}
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(FindIfAndCount)
+{
+	ArrayList<std::string> testList {"A", "BB", "A", "CCC"};
+
+	BOOST_CHECK(testList.count("A") == 2);
+	BOOST_CHECK(testList.find_if([](const std::string& s) { return s.size() == 3; }) == 3);
+	BOOST_CHECK(testList.find_if([](const std::string& s) { return s.empty(); }) == testList.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
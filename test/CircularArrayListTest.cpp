@@ -0,0 +1,169 @@
+#include "../include/CircularArrayList.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(CircularArrayListTests)
+
+BOOST_AUTO_TEST_CASE(Queue)
+{
+	CircularArrayList<int> testList;
+	for(int i = 0; i < 6; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	BOOST_CHECK(testList.capacity() == 8);
+
+	// Cycle through far more elements than the capacity, it must never grow
+	for(int i = 6; i < 1000; ++i)
+	{
+		BOOST_REQUIRE(testList.pop_front() == i - 6);
+		testList.push_back(i);
+	}
+
+	BOOST_CHECK(testList.capacity() == 8);
+	BOOST_CHECK(testList.front() == 994);
+	BOOST_CHECK(testList.back() == 999);
+	BOOST_CHECK(testList.find(997) == 3);
+	BOOST_CHECK(!testList.contains(5));
+	BOOST_CHECK_THROW(testList.at(6), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(BothEnds)
+{
+	std::mt19937 random(3);
+	CircularArrayList<std::unique_ptr<int>> testList;
+	std::deque<int> expected;
+
+	for(int i = 0; i < 5000; ++i)
+	{
+		switch(random() % 4)
+		{
+			case 0:
+				testList.emplace_front(new int(i));
+				expected.push_front(i);
+				break;
+			case 1:
+				testList.push_back(std::make_unique<int>(i));
+				expected.push_back(i);
+				break;
+			case 2:
+				if(!expected.empty())
+				{
+					BOOST_REQUIRE(*testList.pop_front() == expected.front());
+					expected.pop_front();
+				}
+				break;
+			default:
+				if(!expected.empty())
+				{
+					BOOST_REQUIRE(*testList.pop_back() == expected.back());
+					expected.pop_back();
+				}
+				break;
+		}
+	}
+
+	BOOST_REQUIRE(testList.size() == expected.size());
+	BOOST_CHECK(std::has_single_bit(testList.capacity()));
+	for(size_t i = 0; i < expected.size(); ++i)
+	{
+		BOOST_REQUIRE(*testList[i] == expected[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(Spans)
+{
+	CircularArrayList<int> testList;
+	testList.reserve(8);
+	for(int i = 0; i < 6; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	testList.erase_front(5);
+	std::vector<int> batch {6, 7, 8, 9};
+	testList.append(batch);
+
+	// 5 sits at the end of the buffer, the batch wrapped around to the front
+	auto [first, second] = testList.spans();
+	BOOST_CHECK(first.size() + second.size() == 5);
+	BOOST_CHECK(!second.empty());
+	BOOST_CHECK(first[0] == 5);
+	BOOST_CHECK(second.back() == 9);
+
+	// Appending from ourselves, the second time the buffer has to grow underneath the source
+	testList.append(testList.spans().first);
+	BOOST_CHECK(testList.capacity() == 8);
+	testList.append(testList.spans().first);
+	BOOST_CHECK(testList.capacity() == 16);
+
+	std::vector<int> values(testList.begin(), testList.end());
+	BOOST_CHECK((values == std::vector<int> {5, 6, 7, 8, 9, 5, 6, 7, 5, 6, 7}));
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove)
+{
+	CircularArrayList<std::string> testList {"B", "C"};
+	testList.push_front("A");
+
+	CircularArrayList<std::string> copy = testList;
+	BOOST_CHECK(copy == testList);
+
+	CircularArrayList<std::string> moved = std::move(copy);
+	BOOST_CHECK(moved == testList);
+	BOOST_CHECK(copy.empty());
+
+	moved.pop_back();
+	moved.shrink_to_fit();
+	BOOST_CHECK(moved.capacity() == 2);
+	BOOST_CHECK(moved != testList);
+}
+
+BOOST_AUTO_TEST_CASE(AssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+	TrackingResource fallback;
+	std::pmr::memory_resource* previous = std::pmr::set_default_resource(&fallback);
+
+	{
+		using PmrList = CircularArrayList<int, std::pmr::polymorphic_allocator<int>>;
+		PmrList testList({1, 2, 3}, &arena);
+		PmrList source({4, 5, 6}, &other);
+		source.push_front(3);
+		source.pop_back();
+		source.push_back(7);
+
+		testList = source;
+		BOOST_CHECK(testList == source);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		PmrList moved({8, 9}, &other);
+		testList = std::move(moved);
+		BOOST_CHECK(testList.size() == 2);
+		BOOST_CHECK(testList.front() == 8);
+		BOOST_CHECK(moved.empty());
+
+		// Appending its own elements has to grow through a copy, which must come from the same resource
+		testList.append(testList.spans().first);
+		BOOST_CHECK(testList.size() == 4);
+		BOOST_CHECK(testList.back() == 9);
+	}
+
+	std::pmr::set_default_resource(previous);
+	BOOST_CHECK(fallback.allocations() == 0);
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
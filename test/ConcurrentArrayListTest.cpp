@@ -0,0 +1,151 @@
+#include "../include/ConcurrentArrayList.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(ConcurrentArrayListTests)
+
+BOOST_AUTO_TEST_CASE(SingleThreaded)
+{
+	ConcurrentArrayList<std::string> testList {"A", "B"};
+	BOOST_CHECK(testList.push_back("C") == 2);
+	testList.emplace_back(3, 'D');
+
+	BOOST_CHECK(testList.size() == 4);
+	BOOST_CHECK(testList.front() == "A");
+	BOOST_CHECK(testList.back() == "DDD");
+	BOOST_CHECK_THROW(testList.at(4), std::out_of_range);
+	BOOST_CHECK_THROW(testList[4], std::out_of_range);
+	BOOST_CHECK_THROW(testList[std::size_t(-1)], std::out_of_range);
+
+	std::string value;
+	for(const std::string& element : testList)
+	{
+		value += element;
+	}
+
+	BOOST_CHECK(value == "ABCDDD");
+
+	testList.clear();
+	BOOST_CHECK(testList.empty());
+	BOOST_CHECK(testList.capacity() >= 4);
+}
+
+BOOST_AUTO_TEST_CASE(ReferencesStayValid)
+{
+	ConcurrentArrayList<int> testList;
+	testList.push_back(42);
+	int* first = &testList[0];
+
+	for(int i = 0; i < 100000; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	BOOST_CHECK(first == &testList[0]);
+	BOOST_CHECK(*first == 42);
+	BOOST_CHECK(testList[100000] == 99999);
+
+	BOOST_CHECK(testList.grow_by(3, 7) == 100001);
+	BOOST_CHECK(testList.back() == 7);
+	BOOST_CHECK(testList.end() - testList.begin() == 100004);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentAppend)
+{
+	constexpr int THREADS = 8;
+	constexpr int PER_THREAD = 20000;
+
+	ConcurrentArrayList<int> testList;
+	std::atomic<bool> done{false};
+
+	// Reader indexing live elements while the writers append
+	std::thread reader([&testList, &done]
+	{
+		long long seen = 0;
+		while(!done.load())
+		{
+			std::size_t currentSize = testList.size();
+			if(currentSize != 0)
+			{
+				seen += testList[currentSize - 1];
+			}
+		}
+
+		(void)seen;
+	});
+
+	std::vector<std::thread> writers;
+	for(int t = 0; t < THREADS; ++t)
+	{
+		writers.emplace_back([&testList, t]
+		{
+			for(int i = 0; i < PER_THREAD; ++i)
+			{
+				testList.push_back(t * PER_THREAD + i);
+			}
+		});
+	}
+
+	for(std::thread& writer : writers)
+	{
+		writer.join();
+	}
+
+	done = true;
+	reader.join();
+
+	BOOST_CHECK(testList.size() == THREADS * PER_THREAD);
+
+	std::vector<int> values(testList.begin(), testList.end());
+	std::sort(values.begin(), values.end());
+	for(int i = 0; i < THREADS * PER_THREAD; ++i)
+	{
+		if(values[static_cast<std::size_t>(i)] != i)
+		{
+			BOOST_FAIL("Lost or duplicated element");
+		}
+	}
+}
+
+struct Fragile
+{
+	static inline int copies = 0;
+	int value;
+
+	explicit Fragile(int val)
+		: value(val)
+	{
+	}
+
+	Fragile(const Fragile& other)
+		: value(other.value)
+	{
+		if(++copies == 3)
+		{
+			throw std::runtime_error("Copy failed");
+		}
+	}
+};
+
+BOOST_AUTO_TEST_CASE(ThrowingGrowBy)
+{
+	ConcurrentArrayList<Fragile> testList;
+	BOOST_CHECK_THROW(testList.grow_by(1000, Fragile(5)), std::runtime_error);
+	BOOST_CHECK(testList.size() == 1000);
+	BOOST_CHECK(testList[1].value == 5);
+	BOOST_CHECK_THROW(testList[2], std::runtime_error);
+	BOOST_CHECK_THROW(testList.at(999), std::runtime_error);
+
+	testList.clear();
+	BOOST_CHECK(testList.empty());
+	testList.push_back(Fragile(6));
+	BOOST_CHECK(testList.front().value == 6);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
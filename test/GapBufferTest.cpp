@@ -0,0 +1,125 @@
+#include "../include/GapBuffer.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(GapBufferTests)
+
+BOOST_AUTO_TEST_CASE(EditAroundCursor)
+{
+	GapBuffer<char> testList;
+	for(char c : std::string("helloworld"))
+	{
+		testList.push_back(c);
+	}
+
+	testList.insert(',', 5);
+	testList.insert(' ', 6);
+	BOOST_CHECK(testList.gap_position() == 7);
+
+	testList.push_front('>');
+	testList.push_back('!');
+
+	BOOST_CHECK(std::string(testList.begin(), testList.end()) == ">hello, world!");
+	BOOST_CHECK(testList.erase(0) == '>');
+	BOOST_CHECK(testList.pop_back() == '!');
+	BOOST_CHECK(testList.find('w') == 7);
+	BOOST_CHECK(testList.find('z') == testList.size());
+	BOOST_CHECK(testList.front() == 'h');
+	BOOST_CHECK(testList.back() == 'd');
+	BOOST_CHECK_THROW(testList.at(12), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesDeque)
+{
+	std::mt19937 random(7);
+	GapBuffer<std::unique_ptr<int>> testList;
+	std::deque<int> expected;
+
+	for(int i = 0; i < 5000; ++i)
+	{
+		size_t index = random() % (expected.size() + 1);
+		if(random() % 3 == 0 && !expected.empty())
+		{
+			index = std::min(index, expected.size() - 1);
+			BOOST_REQUIRE(*testList.erase(index) == expected[index]);
+			expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(index));
+		}
+		else
+		{
+			testList.emplace(index, new int(i));
+			expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(index), i);
+		}
+	}
+
+	BOOST_REQUIRE(testList.size() == expected.size());
+	for(size_t i = 0; i < expected.size(); ++i)
+	{
+		BOOST_REQUIRE(*testList[i] == expected[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndCompare)
+{
+	GapBuffer<std::string> testList {"B", "C"};
+	testList.push_front("A");
+	testList.insert(testList[0], 2);
+
+	GapBuffer<std::string> copy = testList;
+	BOOST_CHECK(copy == testList);
+	BOOST_CHECK(copy[2] == "A");
+
+	copy.replace("Z", 3);
+	BOOST_CHECK(testList < copy);
+
+	GapBuffer<std::string> moved = std::move(copy);
+	BOOST_CHECK(moved.size() == 4);
+	BOOST_CHECK(copy.empty());
+
+	moved.clear();
+	BOOST_CHECK(moved.empty());
+	moved.shrink_to_fit();
+	BOOST_CHECK(moved.capacity() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(AssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		using PmrBuffer = GapBuffer<int, std::pmr::polymorphic_allocator<int>>;
+		PmrBuffer testList({1, 2, 3}, &arena);
+		PmrBuffer source({4, 5, 6, 7}, &other);
+		source.insert(9, 1);
+
+		testList = source;
+		BOOST_CHECK(testList == source);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		PmrBuffer moved({8}, &other);
+		testList = std::move(moved);
+		BOOST_CHECK(testList.size() == 1);
+		BOOST_CHECK(testList[0] == 8);
+		BOOST_CHECK(moved.empty());
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		// Equal allocators just hand the buffer over
+		PmrBuffer local({10, 11}, &arena);
+		testList = std::move(local);
+		BOOST_CHECK(testList.size() == 2);
+		BOOST_CHECK(arena.outstanding() == 1);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
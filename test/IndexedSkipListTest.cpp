@@ -0,0 +1,182 @@
+#include "../include/IndexedSkipList.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(IndexedSkipListTests)
+
+BOOST_AUTO_TEST_CASE(PositionalMatchesVector)
+{
+	IndexedSkipList<int> testList;
+	std::vector<int> reference;
+	std::mt19937 random(21);
+
+	for(int i = 0; i < 3000; ++i)
+	{
+		size_t index = random() % (reference.size() + 1);
+		testList.insert(i, index);
+		reference.insert(reference.begin() + static_cast<std::ptrdiff_t>(index), i);
+	}
+
+	for(int i = 0; i < 1000; ++i)
+	{
+		size_t index = random() % reference.size();
+		BOOST_REQUIRE(testList.erase(index) == reference[index]);
+		reference.erase(reference.begin() + static_cast<std::ptrdiff_t>(index));
+
+		index = random() % reference.size();
+		testList.replace(-i, index);
+		reference[index] = -i;
+	}
+
+	BOOST_REQUIRE(testList.size() == reference.size());
+	for(size_t i = 0; i < reference.size(); ++i)
+	{
+		BOOST_REQUIRE(testList[i] == reference[i]);
+	}
+
+	BOOST_CHECK(std::equal(testList.begin(), testList.end(), reference.begin(), reference.end()));
+	BOOST_CHECK(testList.front() == reference.front());
+	BOOST_CHECK(testList.back() == reference.back());
+}
+
+BOOST_AUTO_TEST_CASE(FrontAndBack)
+{
+	IndexedSkipList<std::string> testList;
+	BOOST_CHECK_THROW(testList.front(), std::out_of_range);
+	BOOST_CHECK_THROW(testList.pop_back(), std::out_of_range);
+	BOOST_CHECK_THROW(testList.insert("x", 1), std::out_of_range);
+
+	testList.push_back("b");
+	testList.push_front("a");
+	testList.push_back("c");
+	BOOST_CHECK(testList.emplace(3, 2, 'd') == "dd");
+
+	BOOST_CHECK(testList.pop_front() == "a");
+	BOOST_CHECK(testList.pop_back() == "dd");
+	BOOST_CHECK(testList.size() == 2);
+	BOOST_CHECK_THROW(testList.at(2), std::out_of_range);
+
+	testList.clear();
+	BOOST_CHECK(testList.empty());
+	BOOST_CHECK(testList.begin() == testList.end());
+
+	// Still usable after clear
+	testList.push_back("e");
+	BOOST_CHECK(testList.at(0) == "e");
+}
+
+BOOST_AUTO_TEST_CASE(KeyedMode)
+{
+	IndexedSkipList<int> testList;
+	std::vector<int> reference;
+	std::mt19937 random(7);
+
+	for(int i = 0; i < 2000; ++i)
+	{
+		int value = static_cast<int>(random() % 500);
+		size_t index = testList.insert_sorted(value);
+
+		auto position = std::upper_bound(reference.begin(), reference.end(), value);
+		BOOST_REQUIRE(index == static_cast<size_t>(position - reference.begin()));
+		reference.insert(position, value);
+	}
+
+	BOOST_CHECK(std::is_sorted(testList.begin(), testList.end()));
+
+	for(int value = -1; value <= 500; ++value)
+	{
+		auto lower = std::lower_bound(reference.begin(), reference.end(), value);
+		auto upper = std::upper_bound(reference.begin(), reference.end(), value);
+		BOOST_REQUIRE(testList.lower_bound(value) == static_cast<size_t>(lower - reference.begin()));
+		BOOST_REQUIRE(testList.upper_bound(value) == static_cast<size_t>(upper - reference.begin()));
+		BOOST_REQUIRE(testList.find(value) == ((lower != upper) ? testList.lower_bound(value) : testList.size()));
+	}
+
+	// Positional access still works on a keyed list
+	BOOST_CHECK(testList[1000] == reference[1000]);
+
+	int present = reference[1234];
+	BOOST_CHECK(testList.remove(present));
+	reference.erase(std::lower_bound(reference.begin(), reference.end(), present));
+	BOOST_CHECK(!testList.remove(1000));
+	BOOST_CHECK(std::equal(testList.begin(), testList.end(), reference.begin(), reference.end()));
+}
+
+BOOST_AUTO_TEST_CASE(CustomCompare)
+{
+	IndexedSkipList<int, std::greater<int>> testList;
+	for(int i : {3, 1, 4, 1, 5, 9, 2, 6})
+	{
+		testList.insert_sorted(i);
+	}
+
+	BOOST_CHECK(testList == (IndexedSkipList<int, std::greater<int>>{9, 6, 5, 4, 3, 2, 1, 1}));
+	BOOST_CHECK(testList.find(4) == 3);
+	BOOST_CHECK(!testList.contains(7));
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove)
+{
+	IndexedSkipList<std::unique_ptr<int>> owners;
+	owners.push_back(std::make_unique<int>(1));
+	owners.insert(std::make_unique<int>(0), 0);
+
+	IndexedSkipList<std::unique_ptr<int>> moved = std::move(owners);
+	BOOST_CHECK(owners.empty());
+	BOOST_CHECK(*moved[0] == 0 && *moved[1] == 1);
+
+	IndexedSkipList<std::string> original = {"a", "b", "c"};
+	IndexedSkipList<std::string> copy = original;
+	copy.replace("z", 1);
+	BOOST_CHECK(original[1] == "b");
+	BOOST_CHECK(copy != original);
+
+	copy = original;
+	BOOST_CHECK(copy == original);
+	copy.push_back("d");
+	BOOST_CHECK(copy.size() == 4 && original.size() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(AssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		using PmrList = IndexedSkipList<int, std::less<int>, std::pmr::polymorphic_allocator<int>>;
+		PmrList testList({}, &arena);
+		testList.push_back(1);
+		PmrList source({}, &other);
+		for(int i = 0; i < 100; ++i)
+		{
+			source.push_back(i);
+		}
+
+		testList = source;
+		BOOST_CHECK(testList == source);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		PmrList moved({}, &other);
+		moved.push_back(7);
+		moved.push_back(8);
+		testList = std::move(moved);
+		BOOST_CHECK(testList.size() == 2);
+		BOOST_CHECK(testList[1] == 8);
+		BOOST_CHECK(moved.empty());
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,131 @@
+#include "../include/IntrusiveList.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct Timer
+	{
+		explicit Timer(int id)
+			: id(id)
+		{
+		}
+
+		int id;
+		IntrusiveListHook activeHook;
+		std::string name = "timer";
+		IntrusiveListHook expiredHook;
+	};
+
+	using ActiveList = IntrusiveList<Timer, &Timer::activeHook>;
+	using ExpiredList = IntrusiveList<Timer, &Timer::expiredHook>;
+
+	std::vector<int> ids(const ActiveList& list)
+	{
+		std::vector<int> result;
+		for(const Timer& timer : list)
+		{
+			result.push_back(timer.id);
+		}
+
+		return result;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(IntrusiveListTests)
+
+BOOST_AUTO_TEST_CASE(LinkInPlace)
+{
+	Timer a(1), b(2), c(3);
+	ActiveList active;
+
+	active.push_back(b);
+	active.push_front(a);
+	active.insert(active.end(), c);
+
+	BOOST_CHECK((ids(active) == std::vector<int> {1, 2, 3}));
+	BOOST_CHECK(&active.front() == &a);
+	BOOST_CHECK(&active.back() == &c);
+	BOOST_CHECK(active.size() == 3);
+	BOOST_CHECK_THROW(active.push_back(a), std::invalid_argument);
+
+	// Unlink from the object itself, no list needed
+	b.activeHook.unlink();
+	BOOST_CHECK((ids(active) == std::vector<int> {1, 3}));
+	BOOST_CHECK(!b.activeHook.is_linked());
+
+	BOOST_CHECK(&active.pop_back() == &c);
+	BOOST_CHECK(active.erase(ActiveList::iterator_to(a)) == active.end());
+	BOOST_CHECK(active.empty());
+	BOOST_CHECK_THROW(active.pop_front(), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(SeveralListsAtOnce)
+{
+	Timer a(1), b(2);
+	ActiveList active;
+	ExpiredList expired;
+
+	active.push_back(a);
+	active.push_back(b);
+	expired.push_back(b);
+
+	BOOST_CHECK(&expired.front() == &b);
+	ActiveList::remove(b);
+	BOOST_CHECK((ids(active) == std::vector<int> {1}));
+	BOOST_CHECK(expired.front().id == 2);
+
+	std::vector<int> reversed;
+	active.push_back(b);
+	for(auto it = active.rbegin(); it != active.rend(); ++it)
+	{
+		reversed.push_back(it->id);
+	}
+
+	BOOST_CHECK((reversed == std::vector<int> {2, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(Lifetimes)
+{
+	ActiveList active;
+	Timer a(1);
+	active.push_back(a);
+
+	{
+		// Dies while linked and takes itself out
+		Timer temporary(2);
+		active.push_back(temporary);
+		BOOST_CHECK(active.size() == 2);
+	}
+
+	BOOST_CHECK(active.size() == 1);
+
+	// Copies don't inherit membership
+	Timer copy = a;
+	BOOST_CHECK(!copy.activeHook.is_linked());
+
+	ActiveList moved = std::move(active);
+	BOOST_CHECK(active.empty());
+	BOOST_CHECK(&moved.front() == &a);
+
+	ActiveList other;
+	Timer b(2);
+	other.push_back(b);
+	moved.splice(other);
+	BOOST_CHECK(other.empty());
+	BOOST_CHECK((ids(moved) == std::vector<int> {1, 2}));
+
+	{
+		ActiveList shortLived;
+		shortLived.splice(moved);
+	}
+
+	// The list went away first, the objects are unlinked and free again
+	BOOST_CHECK(!a.activeHook.is_linked());
+	BOOST_CHECK(!b.activeHook.is_linked());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
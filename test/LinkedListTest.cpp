@@ -0,0 +1,388 @@
+#include "../include/LinkedList.hpp"
+#include "../include/SlabAllocator.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(LinkedListTests)
+
+BOOST_AUTO_TEST_CASE(InsertAndErase)
+{
+	LinkedList<int> testList;
+	testList.push_back(1);
+	testList.push_back(3);
+	testList.insert(2, 1);
+	testList.push_front(0);
+
+	BOOST_CHECK(testList.size() == 4);
+	BOOST_CHECK(testList.front() == 0);
+	BOOST_CHECK(testList.back() == 3);
+	BOOST_CHECK(testList[2] == 2);
+	BOOST_CHECK(testList.find(3) == 3);
+	BOOST_CHECK_THROW(testList.at(4), std::out_of_range);
+	BOOST_CHECK_THROW(testList.insert(9, 5), std::out_of_range);
+
+	BOOST_CHECK(testList.erase(1) == 1);
+	BOOST_CHECK(testList.pop_back() == 3);
+	BOOST_CHECK(testList.pop_front() == 0);
+	testList.remove(2);
+	BOOST_CHECK(testList.empty());
+	BOOST_CHECK_THROW(testList.pop_front(), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove)
+{
+	LinkedList<std::string> testList {"A", "B", "C"};
+	testList.replace("Z", 1);
+
+	LinkedList<std::string> copy = testList;
+	BOOST_CHECK(copy == testList);
+	BOOST_CHECK(copy.at(1) == "Z");
+
+	LinkedList<std::string> moved = std::move(copy);
+	BOOST_CHECK(moved == testList);
+	BOOST_CHECK(copy.empty());
+
+	copy = moved;
+	moved.pop_back();
+	BOOST_CHECK(copy != moved);
+
+	LinkedList<std::unique_ptr<int>> moveOnly;
+	moveOnly.push_back(std::make_unique<int>(1));
+	moveOnly.push_front(std::make_unique<int>(0));
+	BOOST_CHECK(*moveOnly.back() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(TailPointer)
+{
+	LinkedList<int> testList;
+	for(int i = 0; i < 100; ++i)
+	{
+		testList.push_back(i);
+		BOOST_REQUIRE(testList.back() == i);
+	}
+
+	BOOST_CHECK(testList.pop_back() == 99);
+	BOOST_CHECK(testList.back() == 98);
+	BOOST_CHECK(testList.erase(98) == 98);
+	testList.push_back(-1);
+	BOOST_CHECK(testList[98] == -1);
+
+	// Emptying the list has to reset the tail as well
+	while(!testList.empty())
+	{
+		testList.pop_front();
+	}
+
+	testList.push_back(7);
+	BOOST_CHECK(testList.front() == 7);
+	BOOST_CHECK(testList.back() == 7);
+}
+
+BOOST_AUTO_TEST_CASE(DoublyLinked)
+{
+	DoublyLinkedList<std::string> testList {"B", "C"};
+	testList.push_front("A");
+	testList.push_back("D");
+	testList.insert("X", 2);
+
+	// Second half of the list is reached through the back links
+	BOOST_CHECK(testList.at(3) == "C");
+	BOOST_CHECK(testList.at(1) == "B");
+
+	BOOST_CHECK(testList.erase(3) == "C");
+	BOOST_CHECK(testList.pop_back() == "D");
+	BOOST_CHECK(testList.pop_back() == "X");
+	BOOST_CHECK(testList.back() == "B");
+
+	DoublyLinkedList<std::string> copy = testList;
+	copy.push_back("E");
+	BOOST_CHECK(copy.at(2) == "E");
+	BOOST_CHECK(copy.pop_back() == "E");
+	BOOST_CHECK(copy == testList);
+
+	testList.pop_front();
+	testList.pop_front();
+	BOOST_CHECK(testList.empty());
+	testList.push_front("Z");
+	BOOST_CHECK(testList.back() == "Z");
+}
+
+BOOST_AUTO_TEST_CASE(SlabNodes)
+{
+	SlabAllocator<int> slab;
+	LinkedList<int, SlabAllocator<int>> first(slab);
+	LinkedList<int, SlabAllocator<int>> second(slab);
+
+	for(int i = 0; i < 10000; ++i)
+	{
+		first.push_front(i);
+		second.push_front(-i);
+	}
+
+	// Both lists share one arena and its nodes come in 64 KiB blocks, not one allocation each
+	size_t blocks = slab.arena()->block_count();
+	BOOST_CHECK(blocks > 0);
+	BOOST_CHECK(blocks < 20);
+
+	// Freed nodes go on the free list and get reused
+	for(int i = 0; i < 5000; ++i)
+	{
+		first.pop_front();
+	}
+
+	for(int i = 0; i < 5000; ++i)
+	{
+		first.push_front(i);
+	}
+
+	BOOST_CHECK(slab.arena()->block_count() == blocks);
+	BOOST_CHECK(first.size() == 10000);
+	BOOST_CHECK(second.front() == -9999);
+
+	LinkedList<int, SlabAllocator<int>> copy = first;
+	BOOST_CHECK(copy == first);
+	BOOST_CHECK(copy.get_allocator() == slab);
+}
+
+BOOST_AUTO_TEST_CASE(LongListTeardown)
+{
+	// Deep enough that a recursive teardown would run out of stack
+	{
+		LinkedList<int> testList;
+		for(int i = 0; i < 1000000; ++i)
+		{
+			testList.push_back(i);
+		}
+
+		testList.clear();
+		BOOST_CHECK(testList.empty());
+		testList.push_back(1);
+		BOOST_CHECK(testList.back() == 1);
+
+		for(int i = 0; i < 1000000; ++i)
+		{
+			testList.push_front(i);
+		}
+	}
+
+	// Sole owner of its arena, clear() hands back whole blocks
+	LinkedList<int, SlabAllocator<int>> slabList;
+	for(int i = 0; i < 100000; ++i)
+	{
+		slabList.push_front(i);
+	}
+
+	BOOST_CHECK(slabList.get_allocator().arena()->block_count() > 1);
+	slabList.clear();
+	BOOST_CHECK(slabList.get_allocator().arena()->block_count() == 0);
+
+	slabList.push_back(3);
+	BOOST_CHECK(slabList.front() == 3);
+
+	// Shared arena, nodes go back one by one and the other list keeps its own
+	SlabAllocator<std::string> slab;
+	LinkedList<std::string, SlabAllocator<std::string>> first(slab);
+	LinkedList<std::string, SlabAllocator<std::string>> second(slab);
+	first.push_back("A");
+	second.push_back("B");
+	first.clear();
+	BOOST_CHECK(second.front() == "B");
+	BOOST_CHECK(slab.arena()->block_count() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(Iterators)
+{
+	LinkedList<int> testList;
+	auto last = testList.insert_after(testList.before_begin(), 1);
+	last = testList.insert_after(last, 3);
+	testList.emplace_after(testList.begin(), 2);
+	testList.push_back(4);
+
+	BOOST_CHECK((std::vector<int>(testList.begin(), testList.end()) == std::vector<int>{1, 2, 3, 4}));
+
+	for(int& value : testList)
+	{
+		value *= 10;
+	}
+
+	auto next = testList.erase_after(testList.begin());
+	BOOST_CHECK(*next == 30);
+	auto forty = std::next(testList.begin(), 2);
+	BOOST_CHECK(testList.erase_after(testList.before_begin(), forty) == forty);
+	BOOST_CHECK(testList.begin() == forty);
+	BOOST_CHECK(testList.size() == 1 && testList.front() == 40 && testList.back() == 40);
+
+	// Erasing the tail moves it back
+	testList.push_front(5);
+	testList.erase_after(testList.cbegin());
+	BOOST_CHECK(testList.back() == 5);
+
+	DoublyLinkedList<int> doubly {1, 2, 3};
+	BOOST_CHECK((std::vector<int>(doubly.rbegin(), doubly.rend()) == std::vector<int>{3, 2, 1}));
+	BOOST_CHECK(*std::prev(doubly.end()) == 3);
+	doubly.erase_after(doubly.begin());
+	BOOST_CHECK(*--doubly.end() == 3 && *std::prev(doubly.end(), 2) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(Splice)
+{
+	DoublyLinkedList<int> first {1, 5};
+	DoublyLinkedList<int> second {2, 3, 4};
+
+	first.splice_after(first.begin(), second);
+	BOOST_CHECK(second.empty());
+	BOOST_CHECK(first == (DoublyLinkedList<int>{1, 2, 3, 4, 5}));
+	BOOST_CHECK(first.at(3) == 4);
+
+	// Range (1, 4) = {2, 3} to the end of the other list
+	second.push_back(0);
+	second.splice_after(second.begin(), first, first.begin(), std::next(first.begin(), 3));
+	BOOST_CHECK(first == (DoublyLinkedList<int>{1, 4, 5}));
+	BOOST_CHECK(second == (DoublyLinkedList<int>{0, 2, 3}));
+	BOOST_CHECK(second.back() == 3 && first.size() == 3 && second.size() == 3);
+	BOOST_CHECK((std::vector<int>(second.rbegin(), second.rend()) == std::vector<int>{3, 2, 0}));
+
+	// Single element within the same list, the tail moving to the front
+	first.splice_after(first.before_begin(), first, std::next(first.begin()));
+	BOOST_CHECK(first == (DoublyLinkedList<int>{5, 1, 4}));
+	BOOST_CHECK(first.back() == 4 && *first.rbegin() == 4);
+
+	LinkedList<int> singly {1, 2};
+	singly.splice_after(std::next(singly.begin()), LinkedList<int> {3, 4});
+	singly.push_back(5);
+	BOOST_CHECK(singly == (LinkedList<int>{1, 2, 3, 4, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(MergeAndSort)
+{
+	LinkedList<int> first {1, 3, 5, 7};
+	LinkedList<int> second {2, 3, 8};
+	first.merge(second);
+	BOOST_CHECK(second.empty());
+	BOOST_CHECK(first == (LinkedList<int>{1, 2, 3, 3, 5, 7, 8}));
+	BOOST_CHECK(first.back() == 8);
+
+	std::mt19937 random(22);
+	std::vector<std::pair<int, int>> reference;
+	DoublyLinkedList<std::pair<int, int>> testList;
+	for(int i = 0; i < 10000; ++i)
+	{
+		reference.emplace_back(static_cast<int>(random() % 100), i);
+		testList.push_back(reference.back());
+	}
+
+	// Sort on the key only, the index shows whether equal keys kept their order
+	auto byKey = [](const std::pair<int, int>& left, const std::pair<int, int>& right) { return left.first < right.first; };
+	std::stable_sort(reference.begin(), reference.end(), byKey);
+	testList.sort(byKey);
+
+	BOOST_CHECK(std::equal(testList.begin(), testList.end(), reference.begin(), reference.end()));
+	BOOST_CHECK(std::equal(testList.rbegin(), testList.rend(), reference.rbegin(), reference.rend()));
+	BOOST_CHECK(testList.back() == reference.back());
+
+	LinkedList<int> descending {4, 9, 1};
+	descending.sort(std::greater<int>());
+	BOOST_CHECK(descending == (LinkedList<int>{9, 4, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(SortThrowingCompare)
+{
+	LinkedList<std::string> testList;
+	for(int i = 0; i < 100; ++i)
+	{
+		testList.push_back(std::to_string(i * 37 % 100));
+	}
+
+	int comparisons = 0;
+	auto throwing = [&comparisons](const std::string& left, const std::string& right)
+	{
+		if(++comparisons == 200)
+		{
+			throw std::runtime_error("compare");
+		}
+
+		return left < right;
+	};
+
+	BOOST_CHECK_THROW(testList.sort(throwing), std::runtime_error);
+
+	// Nothing lost, order unspecified
+	BOOST_CHECK(testList.size() == 100);
+	BOOST_CHECK(std::distance(testList.begin(), testList.end()) == 100);
+	testList.sort();
+	BOOST_CHECK(std::is_sorted(testList.begin(), testList.end()));
+	BOOST_CHECK(testList.back() == "99");
+}
+
+BOOST_AUTO_TEST_CASE(SlabMovedFrom)
+{
+	SlabAllocator<int> slab;
+	SlabAllocator<int> movedSlab = std::move(slab);
+	BOOST_CHECK(slab == movedSlab);
+
+	LinkedList<int, SlabAllocator<int>> source;
+	source.push_back(1);
+	source.push_back(2);
+
+	LinkedList<int, SlabAllocator<int>> target = std::move(source);
+	BOOST_CHECK(target.get_allocator() == source.get_allocator());
+
+	// The moved from list still has a working allocator
+	source.push_back(3);
+	source.push_back(4);
+	BOOST_CHECK(source.pop_front() == 3);
+
+	LinkedList<int, SlabAllocator<int>> assigned;
+	assigned.push_back(5);
+	assigned = std::move(target);
+	target.push_back(6);
+	BOOST_CHECK(target.front() == 6);
+	BOOST_CHECK(assigned == (LinkedList<int, SlabAllocator<int>>{1, 2}));
+
+	// Shared arena, so clearing must free node by node and leave the others intact
+	assigned.clear();
+	BOOST_CHECK(source.front() == 4 && target.front() == 6);
+	source.clear();
+	target.clear();
+	BOOST_CHECK(assigned.get_allocator().arena()->block_count() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		using PmrList = LinkedList<int, std::pmr::polymorphic_allocator<int>, true>;
+		PmrList testList(&arena);
+		PmrList source(&other);
+		for(int i = 0; i < 50; ++i)
+		{
+			testList.push_back(-i);
+			source.push_back(i);
+		}
+
+		testList = source;
+		BOOST_CHECK(testList == source);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+		BOOST_CHECK(arena.outstanding() == 50);
+
+		testList.push_front(-1);
+		BOOST_CHECK(testList.front() == -1);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+#include "../include/LockFreeQueue.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(LockFreeQueueTests)
+
+BOOST_AUTO_TEST_CASE(Fifo)
+{
+	LockFreeQueue<std::string> queue;
+	BOOST_CHECK(queue.empty());
+	BOOST_CHECK(!queue.try_pop());
+
+	queue.push("A");
+	queue.emplace(2, 'B');
+	std::string c = "C";
+	queue.push(c);
+
+	BOOST_CHECK(!queue.empty());
+	BOOST_CHECK(*queue.try_pop() == "A");
+	BOOST_CHECK(*queue.try_pop() == "BB");
+	BOOST_CHECK(*queue.try_pop() == "C");
+	BOOST_CHECK(!queue.try_pop());
+
+	// Left over values are destroyed with the queue
+	LockFreeQueue<std::unique_ptr<int>> owning;
+	owning.push(std::make_unique<int>(1));
+	owning.push(std::make_unique<int>(2));
+	BOOST_CHECK(**owning.try_pop() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(ManyProducersManyConsumers)
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int CONSUMERS = 4;
+	constexpr int PER_PRODUCER = 20000;
+
+	LockFreeQueue<std::unique_ptr<int>> queue;
+	std::atomic<int> consumed{0};
+	std::vector<std::vector<int>> received(CONSUMERS);
+
+	std::vector<std::thread> threads;
+	for(int p = 0; p < PRODUCERS; ++p)
+	{
+		threads.emplace_back([&queue, p]
+		{
+			for(int i = 0; i < PER_PRODUCER; ++i)
+			{
+				queue.push(std::make_unique<int>(p * PER_PRODUCER + i));
+			}
+		});
+	}
+
+	for(int c = 0; c < CONSUMERS; ++c)
+	{
+		threads.emplace_back([&queue, &consumed, &received, c]
+		{
+			while(consumed.load() < PRODUCERS * PER_PRODUCER)
+			{
+				if(std::optional<std::unique_ptr<int>> value = queue.try_pop())
+				{
+					received[static_cast<size_t>(c)].push_back(**value);
+					consumed.fetch_add(1);
+				}
+			}
+		});
+	}
+
+	for(std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::vector<int> all;
+	for(const std::vector<int>& values : received)
+	{
+		// Values from one producer have to come out in the order they went in
+		for(int p = 0; p < PRODUCERS; ++p)
+		{
+			int last = -1;
+			for(int value : values)
+			{
+				if(value / PER_PRODUCER == p)
+				{
+					BOOST_REQUIRE(value > last);
+					last = value;
+				}
+			}
+		}
+
+		all.insert(all.end(), values.begin(), values.end());
+	}
+
+	std::sort(all.begin(), all.end());
+	BOOST_REQUIRE(all.size() == PRODUCERS * PER_PRODUCER);
+	for(int i = 0; i < PRODUCERS * PER_PRODUCER; ++i)
+	{
+		BOOST_REQUIRE(all[static_cast<size_t>(i)] == i);
+	}
+
+	BOOST_CHECK(queue.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+#include "../include/MmapArrayList.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace
+{
+	// Unique file in the temp directory, removed again at the end of the test
+	struct TempFile
+	{
+		TempFile()
+			: path(std::filesystem::temp_directory_path() /
+			       ("mmaparraylist-" + std::to_string(::getpid()) + "-" + std::to_string(counter++)))
+		{
+			std::filesystem::remove(path);
+		}
+
+		~TempFile()
+		{
+			std::filesystem::remove(path);
+		}
+
+		std::string name() const
+		{
+			return path.string();
+		}
+
+		std::filesystem::path path;
+		static inline int counter = 0;
+	};
+
+	struct Record
+	{
+		std::uint64_t id;
+		double values[7];
+	};
+}
+
+BOOST_AUTO_TEST_SUITE(MmapArrayListTests)
+
+BOOST_AUTO_TEST_CASE(PersistsAcrossOpens)
+{
+	TempFile file;
+
+	{
+		MmapArrayList<int> testList(file.name());
+		BOOST_CHECK(testList.empty());
+		BOOST_CHECK(testList.capacity() > 0);
+
+		for(int i = 0; i < 100000; ++i)
+		{
+			testList.push_back(i);
+		}
+
+		testList.insert(-1, 0);
+		BOOST_CHECK(testList.erase(50001) == 50000);
+		testList.replace(7, 1);
+		testList.sync();
+	}
+
+	MmapArrayList<int> reopened(file.name());
+	BOOST_REQUIRE(reopened.size() == 100000);
+	BOOST_CHECK(reopened.front() == -1);
+	BOOST_CHECK(reopened[1] == 7);
+	BOOST_CHECK(reopened.back() == 99999);
+	BOOST_CHECK(reopened.find(50001) == 50001);
+	BOOST_CHECK(!reopened.contains(50000));
+
+	// Spare capacity goes back to the file system
+	reopened.reserve(1000000);
+	BOOST_CHECK(std::filesystem::file_size(file.path) >= 1000000 * sizeof(int));
+	reopened.shrink_to_fit();
+	BOOST_CHECK(std::filesystem::file_size(file.path) < 1000000 * sizeof(int));
+	BOOST_CHECK(reopened.back() == 99999);
+}
+
+BOOST_AUTO_TEST_CASE(ReadOnly)
+{
+	TempFile file;
+	BOOST_CHECK_THROW(MmapArrayList<int>(file.name(), MmapMode::ReadOnly), std::system_error);
+
+	{
+		MmapArrayList<Record> writer(file.name());
+		writer.push_back(Record{1, {1.5}});
+		writer.emplace_back(Record{2, {2.5}});
+	}
+
+	MmapArrayList<Record> reader(file.name(), MmapMode::ReadOnly);
+	BOOST_CHECK(reader.size() == 2);
+	BOOST_CHECK(reader[1].id == 2 && reader[1].values[0] == 2.5);
+	BOOST_CHECK_THROW(reader.push_back(Record{}), std::logic_error);
+	BOOST_CHECK_THROW(reader.erase(0), std::logic_error);
+	BOOST_CHECK(reader.size() == 2);
+
+	reader.advise(MmapAdvice::Sequential);
+	reader.advise(MmapAdvice::WillNeed, 1, 1);
+	BOOST_CHECK_THROW(reader.advise(MmapAdvice::Random, 1, 2), std::out_of_range);
+
+	// Same file, different element type
+	BOOST_CHECK_THROW(MmapArrayList<int>(file.name(), MmapMode::ReadOnly), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(CopyOnWrite)
+{
+	TempFile file;
+
+	{
+		MmapArrayList<std::uint64_t> writer(file.name());
+		for(std::uint64_t i = 0; i < 10; ++i)
+		{
+			writer.push_back(i);
+		}
+	}
+
+	{
+		MmapArrayList<std::uint64_t> copy(file.name(), MmapMode::CopyOnWrite);
+		copy.replace(100, 0);
+		copy.pop_back();
+
+		// Growing past the file moves the list into anonymous memory
+		for(std::uint64_t i = 0; i < 10000; ++i)
+		{
+			copy.push_back(i);
+		}
+
+		BOOST_CHECK(copy.size() == 10009);
+		BOOST_CHECK(copy[0] == 100 && copy[8] == 8 && copy[9] == 0 && copy.back() == 9999);
+		copy.append(copy.span().first(9));
+		BOOST_CHECK(copy.back() == 8);
+	}
+
+	MmapArrayList<std::uint64_t> original(file.name(), MmapMode::ReadOnly);
+	BOOST_CHECK(original.size() == 10);
+	BOOST_CHECK(original[0] == 0 && original.back() == 9);
+}
+
+BOOST_AUTO_TEST_CASE(BadFiles)
+{
+	TempFile file;
+	{
+		std::FILE* handle = std::fopen(file.name().c_str(), "w");
+		std::fputs("definitely not a list, but long enough to hold a header..........", handle);
+		std::fclose(handle);
+	}
+
+	BOOST_CHECK_THROW(MmapArrayList<int>(file.name()), std::runtime_error);
+	BOOST_CHECK_THROW(MmapArrayList<int>("/nonexistent-directory/list"), std::system_error);
+}
+
+BOOST_AUTO_TEST_CASE(Move)
+{
+	TempFile file;
+	MmapArrayList<int> first(file.name());
+	first.append(std::span<const int>({1, 2, 3}));
+
+	MmapArrayList<int> second = std::move(first);
+	BOOST_CHECK(first.empty() && first.begin() == first.end());
+	BOOST_CHECK(second.size() == 3 && second[2] == 3);
+
+	TempFile other;
+	MmapArrayList<int> third(other.name());
+	third = std::move(second);
+	BOOST_CHECK(third.back() == 3);
+	BOOST_CHECK(std::filesystem::exists(other.path));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+#include "../include/ParallelAlgorithms.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	ArrayList<std::int64_t> iota(std::size_t n)
+	{
+		ArrayList<std::int64_t> list;
+		list.reserve(n);
+		for(std::size_t i = 0; i < n; ++i)
+		{
+			list.push_back(static_cast<std::int64_t>(i));
+		}
+
+		return list;
+	}
+}
+
+BOOST_AUTO_TEST_SUITE(ParallelAlgorithmsTests)
+
+BOOST_AUTO_TEST_CASE(ForEachAndTransform)
+{
+	WorkStealingPool pool(4);
+	ArrayList<std::int64_t> testList = iota(200000);
+
+	parallel::for_each(testList, [](std::int64_t& value) { value *= 2; }, pool);
+	BOOST_CHECK(testList[199999] == 399998);
+
+	std::vector<std::int64_t> out(testList.size());
+	parallel::transform(testList, out.begin(), [](std::int64_t value) { return value + 1; }, pool);
+	BOOST_CHECK(out.front() == 1);
+	BOOST_CHECK(out.back() == 399999);
+
+	// In place
+	parallel::transform(testList, testList.begin(), [](std::int64_t value) { return -value; }, pool);
+	BOOST_CHECK(testList[1000] == -2000);
+}
+
+BOOST_AUTO_TEST_CASE(Reduce)
+{
+	WorkStealingPool pool(4);
+	ArrayList<std::int64_t> testList = iota(300001);
+
+	BOOST_CHECK(parallel::reduce(testList, std::int64_t(7), std::plus<>(), pool) == 7 + 300000LL * 300001 / 2);
+	BOOST_CHECK(parallel::reduce(ArrayList<std::int64_t>(), std::int64_t(7), std::plus<>(), pool) == 7);
+
+	// Not commutative, only associative, chunk results have to be combined in order
+	ArrayList<std::string> letters;
+	std::string expected;
+	for(int i = 0; i < 100000; ++i)
+	{
+		letters.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+		expected += letters.back();
+	}
+
+	BOOST_CHECK(parallel::reduce(letters, std::string(">"), std::plus<>(), pool) == ">" + expected);
+}
+
+BOOST_AUTO_TEST_CASE(CountAndFind)
+{
+	WorkStealingPool pool(4);
+	ArrayList<std::int64_t> testList = iota(500000);
+
+	BOOST_CHECK(parallel::count_if(testList, [](std::int64_t value) { return value % 3 == 0; }, pool) == 166667);
+
+	BOOST_CHECK(parallel::find_if(testList, [](std::int64_t value) { return value >= 123456; }, pool) == 123456);
+	BOOST_CHECK(parallel::find_if(testList, [](std::int64_t value) { return value % 100000 == 99999; }, pool) == 99999);
+	BOOST_CHECK(parallel::find_if(testList, [](std::int64_t value) { return value < 0; }, pool) == testList.size());
+
+	// Small inputs run on the calling thread
+	ArrayList<int> small {1, 2, 3};
+	BOOST_CHECK(parallel::find_if(small, [](int value) { return value == 3; }) == 2);
+	BOOST_CHECK(parallel::count_if(small, [](int value) { return value > 1; }) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(PoolAndTaskGroup)
+{
+	WorkStealingPool pool(3);
+	BOOST_CHECK(pool.size() == 3);
+
+	std::atomic<int> counter{0};
+	{
+		TaskGroup group(pool);
+		for(int i = 0; i < 1000; ++i)
+		{
+			// Nested groups must not deadlock, waiting workers run other tasks
+			group.run([&pool, &counter]
+			{
+				TaskGroup inner(pool);
+				inner.run([&counter] { counter.fetch_add(1); });
+				inner.wait();
+			});
+		}
+
+		group.wait();
+	}
+
+	BOOST_CHECK(counter == 1000);
+
+	TaskGroup failing(pool);
+	failing.run([] { throw std::runtime_error("task"); });
+	BOOST_CHECK_THROW(failing.wait(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,217 @@
+#include "../include/Serialization.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+	// Anonymous temp file, rewound before reading
+	struct TempFile
+	{
+		TempFile()
+			: handle(std::tmpfile()), fd(::fileno(handle))
+		{
+		}
+
+		~TempFile()
+		{
+			std::fclose(handle);
+		}
+
+		void rewind() const
+		{
+			::lseek(fd, 0, SEEK_SET);
+		}
+
+		std::FILE* handle;
+		int fd;
+	};
+
+	struct Point
+	{
+		float x, y, z;
+		std::uint8_t tag;
+
+		bool operator==(const Point&) const = default;
+	};
+}
+
+BOOST_AUTO_TEST_SUITE(SerializationTests)
+
+BOOST_AUTO_TEST_CASE(ArrayListRoundTrip)
+{
+	ArrayList<std::uint64_t> original;
+	for(std::uint64_t i = 0; i < 100000; ++i)
+	{
+		original.push_back(i * i);
+	}
+
+	TempFile file;
+	serialization::save(file.fd, original);
+	file.rewind();
+
+	ArrayList<std::uint64_t> loaded = {1, 2, 3};
+	serialization::load(file.fd, loaded);
+	BOOST_CHECK(loaded == original);
+	BOOST_CHECK(loaded.capacity() == original.size());
+
+	// Element size not a multiple of the checksum word, and an empty list
+	ArrayList<Point> points = {{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}};
+	ArrayList<Point> none;
+
+	TempFile pointFile;
+	serialization::save(pointFile.fd, points);
+	serialization::save(pointFile.fd, none);
+	pointFile.rewind();
+
+	ArrayList<Point> loadedPoints;
+	ArrayList<Point> loadedNone = {{0, 0, 0, 0}};
+	serialization::load(pointFile.fd, loadedPoints);
+	serialization::load(pointFile.fd, loadedNone);
+	BOOST_CHECK(loadedPoints == points);
+	BOOST_CHECK(loadedNone.empty());
+}
+
+BOOST_AUTO_TEST_CASE(LinkedListRoundTrip)
+{
+	DoublyLinkedList<short> original;
+	for(int i = 0; i < 70001; ++i)
+	{
+		original.push_back(static_cast<short>(i));
+	}
+
+	TempFile file;
+	serialization::save(file.fd, original);
+	file.rewind();
+
+	// Same format, so a list can be loaded as the other kind
+	ArrayList<short> asArray;
+	serialization::load(file.fd, asArray);
+	BOOST_CHECK(asArray.size() == 70001 && asArray.back() == static_cast<short>(70000));
+
+	file.rewind();
+	DoublyLinkedList<short> loaded;
+	serialization::load(file.fd, loaded);
+	BOOST_CHECK(loaded == original);
+	BOOST_CHECK(loaded.back() == original.back());
+}
+
+BOOST_AUTO_TEST_CASE(ThroughPipe)
+{
+	int fds[2];
+	BOOST_REQUIRE(::pipe(fds) == 0);
+
+	// Far more than the pipe buffer, so both sides see partial reads and writes
+	ArrayList<int> original;
+	for(int i = 0; i < 1000000; ++i)
+	{
+		original.push_back(i);
+	}
+
+	std::thread writer([&] { serialization::save(fds[1], original); ::close(fds[1]); });
+
+	LinkedList<int> loaded;
+	serialization::load(fds[0], loaded);
+	writer.join();
+	::close(fds[0]);
+
+	BOOST_CHECK(loaded.size() == original.size());
+	BOOST_CHECK(loaded.back() == 999999);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsBadSnapshots)
+{
+	ArrayList<int> original = {1, 2, 3, 4};
+	TempFile file;
+	serialization::save(file.fd, original);
+
+	ArrayList<int> target = {42};
+
+	// Wrong element type
+	file.rewind();
+	ArrayList<std::int64_t> wide;
+	BOOST_CHECK_THROW(serialization::load(file.fd, wide), std::runtime_error);
+
+	// Flipped bit in the payload
+	int value = 5;
+	BOOST_REQUIRE(::pwrite(file.fd, &value, sizeof(value), 40) == sizeof(value));
+	file.rewind();
+	BOOST_CHECK_THROW(serialization::load(file.fd, target), std::runtime_error);
+	BOOST_CHECK(target.size() == 1 && target[0] == 42);
+
+	// Cut short
+	BOOST_REQUIRE(::ftruncate(file.fd, 44) == 0);
+	file.rewind();
+	BOOST_CHECK_THROW(serialization::load(file.fd, target), std::runtime_error);
+
+	// Not a snapshot
+	BOOST_REQUIRE(::pwrite(file.fd, "NOTASNAP", 8, 0) == 8);
+	file.rewind();
+	BOOST_CHECK_THROW(serialization::load(file.fd, target), std::runtime_error);
+	BOOST_CHECK(target[0] == 42);
+
+	BOOST_CHECK_THROW(serialization::save(-1, original), std::system_error);
+}
+
+BOOST_AUTO_TEST_CASE(RejectsOversizedCount)
+{
+	ArrayList<int> original = {1, 2, 3, 4};
+	TempFile file;
+	serialization::save(file.fd, original);
+
+	// Claims 2^40 ints (4 TiB) after the header, the file holds 16 bytes
+	std::uint64_t count = std::uint64_t(1) << 40;
+	BOOST_REQUIRE(::pwrite(file.fd, &count, sizeof(count), 16) == sizeof(count));
+
+	ArrayList<int> target = {42};
+	file.rewind();
+	BOOST_CHECK_THROW(serialization::load(file.fd, target), std::runtime_error);
+	BOOST_CHECK(target.size() == 1 && target[0] == 42);
+
+	// A pipe can't be checked up front, it has to run out of data instead of allocating for the count
+	int fds[2];
+	BOOST_REQUIRE(::pipe(fds) == 0);
+
+	char snapshot[56];
+	BOOST_REQUIRE(::pread(file.fd, snapshot, sizeof(snapshot), 0) == sizeof(snapshot));
+	BOOST_REQUIRE(::write(fds[1], snapshot, sizeof(snapshot)) == sizeof(snapshot));
+	::close(fds[1]);
+
+	BOOST_CHECK_THROW(serialization::load(fds[0], target), std::runtime_error);
+	::close(fds[0]);
+	BOOST_CHECK(target.size() == 1 && target[0] == 42);
+}
+
+BOOST_AUTO_TEST_CASE(ChecksumPieces)
+{
+	unsigned char bytes[1001];
+	for(std::size_t i = 0; i < sizeof(bytes); ++i)
+	{
+		bytes[i] = static_cast<unsigned char>(i * 7);
+	}
+
+	serialization::Checksum whole;
+	whole.update(bytes, sizeof(bytes));
+
+	serialization::Checksum pieces;
+	for(std::size_t offset = 0, step = 1; offset < sizeof(bytes); offset += step, step = step % 5 + 1)
+	{
+		pieces.update(bytes + offset, std::min(step, sizeof(bytes) - offset));
+	}
+
+	BOOST_CHECK(whole.value() == pieces.value());
+
+	bytes[500] ^= 1;
+	serialization::Checksum changed;
+	changed.update(bytes, sizeof(bytes));
+	BOOST_CHECK(changed.value() != whole.value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#include "../include/SmallArrayList.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(SmallArrayListTests)
+
+BOOST_AUTO_TEST_CASE(StaysInline)
+{
+	SmallArrayList<int, 4> testList{1, 2, 3};
+	testList.push_back(4);
+
+	BOOST_CHECK(testList.is_inline());
+	BOOST_CHECK(testList.capacity() == 4);
+	BOOST_CHECK(testList.back() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(SpillsToHeapAndBack)
+{
+	SmallArrayList<std::string, 4> testList{"A", "B", "C", "D"};
+	testList.push_back("E");
+
+	BOOST_CHECK(!testList.is_inline());
+	BOOST_CHECK(testList.size() == 5);
+
+	testList.pop_back();
+	testList.shrink_to_fit();
+
+	BOOST_CHECK(testList.is_inline());
+
+	std::string value;
+	for(size_t i = 0; i < testList.size(); ++i)
+	{
+		value += testList.at(i);
+	}
+
+	BOOST_CHECK(value == "ABCD");
+}
+
+BOOST_AUTO_TEST_CASE(InsertEraseFind)
+{
+	SmallArrayList<int, 2> testList;
+	testList.push_back(1);
+	testList.push_back(3);
+	testList.insert(2, 1);
+	testList.push_front(0);
+
+	BOOST_CHECK(testList.find(2) == 2);
+	BOOST_CHECK(testList.contains(3));
+
+	testList.remove(2);
+	BOOST_CHECK(!testList.contains(2));
+	BOOST_CHECK(testList.erase(0) == 0);
+	BOOST_CHECK(testList.size() == 2);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove)
+{
+	SmallArrayList<std::string, 2> inlineList{"A"};
+	SmallArrayList<std::string, 2> heapList{"A", "B", "C"};
+
+	SmallArrayList<std::string, 2> inlineCopy = inlineList;
+	SmallArrayList<std::string, 2> heapCopy = heapList;
+	BOOST_CHECK(inlineCopy == inlineList);
+	BOOST_CHECK(heapCopy == heapList);
+
+	SmallArrayList<std::string, 2> inlineMoved = std::move(inlineCopy);
+	SmallArrayList<std::string, 2> heapMoved = std::move(heapCopy);
+	BOOST_CHECK(inlineMoved == inlineList);
+	BOOST_CHECK(heapMoved == heapList);
+	BOOST_CHECK(inlineCopy.empty());
+	BOOST_CHECK(heapCopy.empty());
+
+	swap(inlineMoved, heapMoved);
+	BOOST_CHECK(inlineMoved == heapList);
+	BOOST_CHECK(heapMoved == inlineList);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		using PmrList = SmallArrayList<int, 2, std::pmr::polymorphic_allocator<int>>;
+		PmrList testList({1, 2, 3}, &arena);
+		PmrList heapSource({4, 5, 6, 7}, &other);
+		PmrList inlineSource({8}, &other);
+
+		testList = heapSource;
+		BOOST_CHECK(testList == heapSource);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		testList = inlineSource;
+		BOOST_CHECK(testList == inlineSource);
+
+		testList = heapSource;
+		testList.push_back(9);
+		BOOST_CHECK(testList.back() == 9);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(Comparison)
+{
+	SmallArrayList<int, 4> testList1 {0, 1};
+	SmallArrayList<int, 4> testList2 {0, 1, 2};
+
+	BOOST_CHECK(testList1 < testList2);
+	BOOST_CHECK(testList2 > testList1);
+	BOOST_CHECK(testList1 != testList2);
+	BOOST_CHECK(testList1 <= testList1);
+}
+
+BOOST_AUTO_TEST_CASE(Emplace)
+{
+	SmallArrayList<std::unique_ptr<int>, 2> testList;
+	testList.emplace_back(new int(1));
+	testList.emplace_back(new int(2));
+	testList.emplace(0, new int(0));
+	testList.push_back(std::make_unique<int>(3));
+
+	BOOST_CHECK(!testList.is_inline());
+	BOOST_CHECK(*testList[0] == 0);
+	BOOST_CHECK(*testList[3] == 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+#include "../include/SortedArrayList.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(SortedArrayListTests)
+
+BOOST_AUTO_TEST_CASE(InsertKeepsOrder)
+{
+	SortedArrayList<int> testList {5, 1, 4};
+	testList.insert(3);
+	testList.insert(0);
+	testList.insert(6);
+
+	BOOST_CHECK(std::is_sorted(testList.begin(), testList.end()));
+	BOOST_CHECK(testList.front() == 0);
+	BOOST_CHECK(testList.back() == 6);
+	BOOST_CHECK(testList.size() == 6);
+}
+
+BOOST_AUTO_TEST_CASE(Bounds)
+{
+	SortedArrayList<int> testList {1, 2, 2, 2, 3, 5};
+
+	BOOST_CHECK(testList.lower_bound(2) == 1);
+	BOOST_CHECK(testList.upper_bound(2) == 4);
+	BOOST_CHECK((testList.equal_range(4) == std::pair<size_t, size_t>(5, 5)));
+	BOOST_CHECK(testList.lower_bound(0) == 0);
+	BOOST_CHECK(testList.lower_bound(9) == 6);
+	BOOST_CHECK(testList.count(2) == 3);
+	BOOST_CHECK(testList.find(4) == testList.size());
+	BOOST_CHECK(testList.contains(5));
+
+	BOOST_CHECK(testList.remove(2));
+	BOOST_CHECK(testList.count(2) == 2);
+	BOOST_CHECK(!testList.remove(4));
+}
+
+BOOST_AUTO_TEST_CASE(CustomCompare)
+{
+	SortedArrayList<std::string, std::greater<std::string>> testList {"A", "C", "B"};
+
+	BOOST_CHECK(testList[0] == "C");
+	BOOST_CHECK(testList.find("A") == 2);
+}
+
+// Both layouts have to agree with std::lower_bound/upper_bound for every key, including ones that aren't present
+template<typename Layout>
+void checkAgainstStd(size_t count)
+{
+	std::mt19937 random(42);
+	std::vector<int> values(count);
+	for(int& value : values)
+	{
+		value = static_cast<int>(random() % (count + 1)) * 2;
+	}
+
+	SortedArrayList<int, std::less<int>, Layout> testList;
+	testList.insert(values.begin(), values.end());
+	std::sort(values.begin(), values.end());
+
+	for(int key = -1; key <= static_cast<int>(count * 2 + 2); ++key)
+	{
+		size_t lower = static_cast<size_t>(std::lower_bound(values.begin(), values.end(), key) - values.begin());
+		size_t upper = static_cast<size_t>(std::upper_bound(values.begin(), values.end(), key) - values.begin());
+
+		BOOST_REQUIRE(testList.lower_bound(key) == lower);
+		BOOST_REQUIRE(testList.upper_bound(key) == upper);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(FlatMatchesStd)
+{
+	for(size_t count : {0, 1, 2, 3, 7, 8, 100, 1000})
+	{
+		checkAgainstStd<FlatLayout>(count);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EytzingerMatchesStd)
+{
+	for(size_t count : {0, 1, 2, 3, 7, 8, 100, 1000})
+	{
+		checkAgainstStd<EytzingerLayout>(count);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(EytzingerRebuildsAfterInsert)
+{
+	SortedArrayList<int, std::less<int>, EytzingerLayout> testList {10, 20, 30};
+	BOOST_CHECK(testList.find(20) == 1);
+
+	testList.insert(15);
+	BOOST_CHECK(testList.find(20) == 2);
+	BOOST_CHECK(testList.find(15) == 1);
+
+	testList.erase(0);
+	testList.rebuild();
+	BOOST_CHECK(testList.lower_bound(16) == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+#ifndef TEST_TRACKINGRESOURCE_HPP_
+#define TEST_TRACKINGRESOURCE_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+#include <unordered_set>
+
+/**
+ * Memory resource for the allocator tests. Every block comes from new/delete, so handing it back through the
+ * wrong resource is still safe, but each resource remembers what it gave out and counts the blocks it was asked
+ * to free that it never allocated.
+ *
+ * Two of these never compare equal, which is exactly the case where a container has to keep the buffers apart.
+ */
+class TrackingResource : public std::pmr::memory_resource
+{
+	public:
+		std::size_t outstanding() const noexcept
+		{
+			return mBlocks.size();
+		}
+
+		std::size_t allocations() const noexcept
+		{
+			return mAllocations;
+		}
+
+		std::size_t foreign() const noexcept
+		{
+			return mForeign;
+		}
+
+	private:
+		std::unordered_set<void*> mBlocks;
+		std::size_t mAllocations = 0;
+		std::size_t mForeign = 0;
+
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			void* block = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+			mBlocks.insert(block);
+			++mAllocations;
+			return block;
+		}
+
+		void do_deallocate(void* block, std::size_t bytes, std::size_t alignment) override
+		{
+			if(mBlocks.erase(block) == 0)
+			{
+				++mForeign;
+			}
+
+			std::pmr::new_delete_resource()->deallocate(block, bytes, alignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+};
+
+#endif /* TEST_TRACKINGRESOURCE_HPP_ */
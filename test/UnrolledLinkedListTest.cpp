@@ -0,0 +1,151 @@
+#include "../include/UnrolledLinkedList.hpp"
+#include "TrackingResource.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(UnrolledLinkedListTests)
+
+BOOST_AUTO_TEST_CASE(NodesFillCacheLines)
+{
+	using List = UnrolledLinkedList<int>;
+	static_assert(List::NODE_CAPACITY == 12, "16 byte header + 12 ints per 64 byte line");
+
+	List testList;
+	for(int i = 0; i < 1200; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	// Appending fills every node completely
+	BOOST_CHECK(testList.node_count() == 100);
+	BOOST_CHECK(testList.at(1199) == 1199);
+	BOOST_CHECK(testList.back() == 1199);
+	BOOST_CHECK(testList.find(777) == 777);
+	BOOST_CHECK(testList.find(-1) == testList.size());
+
+	int expected = 0;
+	for(int value : testList)
+	{
+		BOOST_REQUIRE(value == expected++);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(SplitAndMerge)
+{
+	UnrolledLinkedList<int> testList;
+	for(int i = 0; i < 12; ++i)
+	{
+		testList.push_back(i);
+	}
+
+	testList.insert(100, 3);
+	BOOST_CHECK(testList.node_count() == 2);
+	BOOST_CHECK(testList[3] == 100);
+	BOOST_CHECK(testList[4] == 3);
+
+	testList.erase(3);
+	testList.erase(0);
+	BOOST_CHECK(testList.node_count() == 1);
+	BOOST_CHECK(testList.front() == 1);
+	BOOST_CHECK(testList.size() == 11);
+
+	while(!testList.empty())
+	{
+		testList.pop_back();
+	}
+
+	BOOST_CHECK(testList.node_count() == 0);
+	testList.push_front(5);
+	BOOST_CHECK(testList.back() == 5);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesVector)
+{
+	std::mt19937 random(11);
+	UnrolledLinkedList<std::unique_ptr<int>> testList;
+	std::vector<int> expected;
+
+	for(int i = 0; i < 20000; ++i)
+	{
+		if(random() % 5 < 2 && !expected.empty())
+		{
+			size_t index = random() % expected.size();
+			BOOST_REQUIRE(*testList.erase(index) == expected[index]);
+			expected.erase(expected.begin() + static_cast<std::ptrdiff_t>(index));
+		}
+		else
+		{
+			size_t index = random() % (expected.size() + 1);
+			testList.emplace(index, new int(i));
+			expected.insert(expected.begin() + static_cast<std::ptrdiff_t>(index), i);
+		}
+	}
+
+	BOOST_REQUIRE(testList.size() == expected.size());
+
+	size_t i = 0;
+	for(const std::unique_ptr<int>& value : testList)
+	{
+		BOOST_REQUIRE(*value == expected[i++]);
+	}
+
+	// Merging keeps the nodes from going sparse
+	BOOST_CHECK(testList.node_count() * decltype(testList)::NODE_CAPACITY < 2 * testList.size() + 8);
+}
+
+BOOST_AUTO_TEST_CASE(CopyAndMove)
+{
+	UnrolledLinkedList<std::string, std::allocator<std::string>, 2> testList {"A", "B", "C"};
+	testList.replace("Z", 1);
+
+	auto copy = testList;
+	BOOST_CHECK(copy == testList);
+	BOOST_CHECK(copy.at(1) == "Z");
+
+	auto moved = std::move(copy);
+	BOOST_CHECK(moved == testList);
+	BOOST_CHECK(copy.empty());
+
+	moved.remove("Z");
+	BOOST_CHECK(moved != testList);
+	BOOST_CHECK(!moved.contains("Z"));
+}
+
+BOOST_AUTO_TEST_CASE(AssignmentKeepsAllocator)
+{
+	TrackingResource arena;
+	TrackingResource other;
+
+	{
+		using PmrList = UnrolledLinkedList<int, std::pmr::polymorphic_allocator<int>>;
+		PmrList testList({1, 2, 3}, &arena);
+		PmrList source(&other);
+		for(int i = 0; i < 100; ++i)
+		{
+			source.push_back(i);
+		}
+
+		testList = source;
+		BOOST_CHECK(testList == source);
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+
+		PmrList moved({7, 8}, &other);
+		testList = std::move(moved);
+		BOOST_CHECK(testList.size() == 2);
+		BOOST_CHECK(testList.front() == 7);
+		BOOST_CHECK(moved.empty());
+		BOOST_CHECK(testList.get_allocator().resource() == &arena);
+	}
+
+	BOOST_CHECK(arena.outstanding() == 0);
+	BOOST_CHECK(other.outstanding() == 0);
+	BOOST_CHECK(arena.foreign() == 0);
+	BOOST_CHECK(other.foreign() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()